@@ -16,6 +16,8 @@
 
 namespace hocon {
 
+    class path_filter;
+
     enum class time_unit { NANOSECONDS, MICROSECONDS, MILLISECONDS, SECONDS, MINUTES, HOURS, DAYS };
 
     /**
@@ -508,6 +510,40 @@ namespace hocon {
          */
         virtual bool has_path_or_null(std::string const& path) const;
 
+        /**
+         * Returns a config with the same contents whose {@link #has_path} and
+         * {@link #has_path_or_null} answer most lookups of missing paths from a
+         * bloom filter of its paths, without parsing the path expression or
+         * descending into objects. Building the filter walks the config once,
+         * using about ten bits per path. Configs derived from the result don't
+         * keep the filter.
+         *
+         * <p>
+         * Only plain expressions like <code>a.b-c.d_e</code> use the filter;
+         * quoted or numeric keys are looked up as usual.
+         *
+         * @return a config with a path filter
+         * @throws not_resolved_exception if the config isn't resolved
+         */
+        shared_config with_path_filter() const;
+
+        /**
+         * Returns a copy of this config that's never freed, and
+         * that's read without counting references to its values: the values
+         * it holds and the ones lookups return don't own anything, so looking
+         * up a path only reads the config's memory. Processes forked after
+         * freezing then share its pages instead of each writing to, and so
+         * copying, most of them.
+         *
+         * <p>
+         * Freeze configs that live as long as the process, since their memory
+         * is only reclaimed when it exits.
+         *
+         * @return a frozen copy of this config
+         * @throws not_resolved_exception if the config isn't resolved
+         */
+        shared_config freeze() const;
+
         /**
          * Returns true if the {@code Config}'s root object contains no key-value
          * pairs.
@@ -577,6 +613,18 @@ namespace hocon {
         virtual std::vector<shared_object> get_object_list(std::string const& path) const;
         virtual std::vector<shared_config> get_config_list(std::string const& path) const;
 
+        /**
+         * Gets a list whose elements all have one type as plain C++ values. Packed
+         * lists are read directly, without creating a config_value per element.
+         * Throws wrong_type_exception if an element has a different type, or
+         * if an int or long list has a number with a fraction.
+         */
+        virtual std::vector<bool> get_bool_list(std::string const& path) const;
+        virtual std::vector<int> get_int_list(std::string const& path) const;
+        virtual std::vector<int64_t> get_long_list(std::string const& path) const;
+        virtual std::vector<double> get_double_list(std::string const& path) const;
+        virtual std::vector<std::string> get_string_list(std::string const& path) const;
+
         // TODO: memory parsing
 
         /**
@@ -706,6 +754,7 @@ namespace hocon {
         shared_value find_or_null(path path_expression, config_value::type expected, path original_path) const;
 
         shared_object _object;
+        std::shared_ptr<const path_filter> _path_filter;
     };
 
 }  // namespace hocon
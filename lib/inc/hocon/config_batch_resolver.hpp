@@ -0,0 +1,79 @@
+#pragma once
+
+#include "types.hpp"
+#include "config.hpp"
+#include "config_resolve_options.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * Resolves many configs that all fall back to the same base config, such
+     * as one config per tenant over a shared default. The base is resolved
+     * once, up front. Resolving an overlay then reuses the base's resolved
+     * values, except for those whose substitutions, followed through the
+     * base, refer to a path the overlay sets, or to a path inside or above one.
+     * Those are resolved again, together with the overlay, from the base as
+     * parsed.
+     *
+     * <p>
+     * The result is the same as <code>overlay-&gt;with_fallback(base)-&gt;resolve(options)</code>,
+     * and shares every reused value with the resolved base. It's safe to
+     * resolve overlays from several threads at once.
+     */
+    class config_batch_resolver {
+    public:
+        struct result {
+            shared_config config;
+            /** Approximate bytes taken by the resolved config. */
+            size_t memory_usage;
+            /** How many of those bytes are shared with the resolved base. */
+            size_t shared_memory;
+        };
+
+        /**
+         * Resolves base, leaving substitutions it can't resolve on its own
+         * for the overlays.
+         */
+        explicit config_batch_resolver(shared_config base, config_resolve_options options = config_resolve_options());
+
+        /** The base as resolved on its own; it may have unresolved values. */
+        shared_config resolved_base() const { return _resolved; }
+
+        /** How many of the base's values have substitutions. */
+        size_t substituted_values() const { return _substituted.size(); }
+
+        /** Resolves overlay with the base as its fallback. */
+        result resolve(shared_config const& overlay) const;
+
+        /**
+         * Resolves each overlay with the base as its fallback, on up to threads
+         * threads, or one per hardware thread if threads is 0. Results are in
+         * the order of the overlays; if any overlay fails, the first failure
+         * is rethrown.
+         */
+        std::vector<result> resolve_all(std::vector<shared_config> const& overlays, unsigned threads = 0) const;
+
+    private:
+        /** A base value with substitutions, and every path its resolution reads. */
+        struct substituted {
+            std::vector<std::string> keys;
+            shared_value raw;
+            shared_value resolved;
+            // each path read, as the renderings of its prefixes, shortest first
+            std::vector<std::vector<std::string>> reads;
+        };
+
+        size_t measure(shared_value const& v, size_t& shared_memory) const;
+
+        config_resolve_options _options;
+        shared_config _resolved;
+        std::vector<substituted> _substituted;
+        // approximate bytes of every value in the resolved base, including its children
+        std::unordered_map<config_value const*, size_t> _base_memory;
+    };
+
+}  // namespace hocon
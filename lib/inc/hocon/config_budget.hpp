@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace hocon {
+
+    /**
+     * Limits on the work parsing and resolving may do. Zero means no limit.
+     */
+    struct config_limits {
+        /** Bytes read, counting every included file. */
+        size_t max_bytes = 0;
+        /** Tokens parsed, counting every included file. */
+        size_t max_tokens = 0;
+        /** How deeply objects and lists may nest within one file. */
+        size_t max_depth = 0;
+        /** Include statements followed. */
+        size_t max_includes = 0;
+        /** Substitutions looked up while resolving. */
+        size_t max_expansions = 0;
+        /** Bytes of strings and elements of lists built by concatenations while resolving. */
+        size_t max_output = 0;
+        /** How long after the budget is made the work must be done. */
+        std::chrono::milliseconds time_limit { 0 };
+    };
+
+    /**
+     * Counts the work done by the parses and resolves it's given to against a
+     * set of limits, and throws budget_exceeded_exception from whichever one
+     * goes over. Those parses and resolves are counted together, even when
+     * they run on different threads, and the time limit starts when the
+     * budget is made.
+     *
+     * <p>
+     * Pass a budget to {@link config_parse_options#set_budget} and
+     * {@link config_resolve_options#set_budget}. Without one nothing is
+     * counted. Objects are parsed up front when there's a budget, so lazy
+     * parsing is off.
+     */
+    class config_budget {
+    public:
+        explicit config_budget(config_limits limits);
+
+        config_limits const& limits() const { return _limits; }
+
+        void spend_bytes(size_t bytes);
+        void spend_token();
+        void check_depth(size_t depth) const;
+        void spend_include();
+        void spend_expansion();
+        void spend_output(size_t amount);
+
+        /** Throws if the time limit has passed. */
+        void check_deadline() const;
+
+        size_t bytes() const { return _bytes; }
+        size_t tokens() const { return _tokens; }
+        size_t includes() const { return _includes; }
+        size_t expansions() const { return _expansions; }
+        size_t output() const { return _output; }
+
+    private:
+        [[noreturn]] static void exceeded(size_t limit, std::string const& what);
+
+        config_limits _limits;
+        std::chrono::steady_clock::time_point _deadline;
+        std::atomic<size_t> _bytes, _tokens, _includes, _expansions, _output;
+    };
+
+}  // namespace hocon
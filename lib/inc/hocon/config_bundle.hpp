@@ -0,0 +1,87 @@
+#pragma once
+
+#include "types.hpp"
+#include "config_parse_options.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * A single file holding the sources of a whole tree of config files, indexed
+     * by their path relative to the root of the tree. Opening a bundle maps it
+     * into memory, and parsing a file from it reads its includes from the bundle
+     * too, so a whole load costs one open. Includes that aren't in the bundle are
+     * looked up on the filesystem as usual.
+     *
+     * <p>
+     * The file is a header, an index sorted by path, then the paths and sources.
+     * Integers are little-endian and offsets are from the start of the file.
+     * <pre>
+     *   "HOCONBDL" | version : u32 | count : u32
+     *   count * { path offset : u64 | path length : u32 | flags : u32 | source offset : u64 | source length : u64 }
+     * </pre>
+     * Flags are reserved and written as zero.
+     */
+    class config_bundle : public std::enable_shared_from_this<config_bundle> {
+    public:
+        /** Maps the bundle at bundle_path. Throws io_exception if it can't be read or isn't a bundle. */
+        static std::shared_ptr<const config_bundle> open(std::string const& bundle_path);
+
+        /**
+         * Writes a bundle of the given files, which are paths relative to
+         * root_dir using '/' as the separator. Throws io_exception on failure.
+         */
+        static void write(std::string const& bundle_path, std::string const& root_dir,
+                          std::vector<std::string> const& files);
+
+        config_bundle(config_bundle const&) = delete;
+        config_bundle& operator=(config_bundle const&) = delete;
+        ~config_bundle();
+
+        std::string const& bundle_path() const { return _path; }
+
+        /** The relative paths of the files in the bundle, in sorted order. */
+        std::vector<std::string> paths() const;
+
+        /**
+         * True if the bundle has a file at path. Paths may contain "." and ".."
+         * elements; they're resolved before looking the path up.
+         */
+        bool contains(std::string const& path) const;
+
+        /** The source of the file at path, without copying it; empty if there's no such file. */
+        array_view<char> source(std::string const& path) const;
+
+        /** Resolves "." and ".." elements in a relative path and removes empty ones. */
+        static std::string normalize_path(std::string const& path);
+
+        /** Parses the file at path; includes are read from the bundle where possible. */
+        shared_config parse_file(std::string const& path,
+                                 config_parse_options options = config_parse_options()) const;
+
+    private:
+        struct entry {
+            array_view<char> path;
+            array_view<char> source;
+        };
+
+        explicit config_bundle(std::string path);
+
+        void map();
+        void read_index();
+        entry entry_at(uint32_t index) const;
+        // index of the entry for a normalized path, or -1
+        int64_t find(std::string const& normalized_path) const;
+
+        std::string _path;
+        char const* _data;
+        size_t _size;
+        // holds the file on platforms where it isn't mapped
+        std::string _contents;
+        uint32_t _count;
+    };
+
+}  // namespace hocon
@@ -126,6 +126,14 @@ namespace hocon {
         not_possible_to_resolve_exception(std::string const& message) : bug_or_broken_exception(message) { }
     };
 
+    /**
+     * Exception indicating that parsing or resolving went over one of the
+     * limits of its {@link config_budget}.
+     */
+    struct budget_exceeded_exception : public config_exception {
+        using config_exception::config_exception;
+    };
+
     /**
      * Information about a problem that occurred in {@link config#check_valid}. A
      * {@link validation_failed_exception} thrown from
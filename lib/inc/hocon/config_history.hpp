@@ -0,0 +1,99 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hocon {
+
+    /** A value that differs between two configs; before or after is null if the path was added or removed. */
+    struct config_change {
+        std::string path;
+        shared_value before;
+        shared_value after;
+    };
+
+    /**
+     * Keeps the last few generations of a resolved config, sharing the subtrees
+     * that are equal between them: each object, list and leaf is stored once no
+     * matter how many generations contain it, so a history of a mostly stable
+     * config costs little more than one copy of it. Generations are numbered
+     * from 1 in the order they're added.
+     *
+     * <p>
+     * Equal subtrees are found by content, ignoring origins; a shared subtree
+     * keeps the origin of the first generation it was stored for.
+     *
+     * <p>
+     * The configs returned are immutable and can be used from any thread, but
+     * the history itself must not be modified while it's being read.
+     */
+    class config_history {
+    public:
+        /** Creates a history keeping at most capacity generations; must be at least 1. */
+        explicit config_history(size_t capacity);
+
+        /**
+         * Adds a generation, dropping the oldest if the history is full. Throws
+         * not_resolved_exception if the config isn't resolved.
+         * @return the new generation's number
+         */
+        uint64_t push(shared_config conf);
+
+        /** The config of a generation. Throws config_exception if it isn't in the history. */
+        shared_config get(uint64_t generation) const;
+
+        /** True if the generation is still in the history. */
+        bool contains(uint64_t generation) const;
+
+        /** The number of the newest generation, or 0 if nothing was pushed. */
+        uint64_t latest() const;
+
+        /** The number of the oldest generation kept, or 0 if nothing was pushed. */
+        uint64_t oldest() const;
+
+        size_t size() const { return _generations.size(); }
+
+        /**
+         * The leaf values that differ between two generations, sorted by path.
+         * Lists are compared as whole values.
+         */
+        std::vector<config_change> diff(uint64_t from, uint64_t to) const;
+
+        /**
+         * The leaf values that differ between two resolved configs, sorted by
+         * path. Subtrees that are the same object aren't walked, so configs
+         * from one history, or derived from each other with with_value, are
+         * compared in time proportional to what changed.
+         */
+        static std::vector<config_change> diff(shared_config const& from, shared_config const& to);
+
+        /** The number of distinct values stored for all the generations together. */
+        size_t shared_values() const;
+
+    private:
+        struct interned {
+            std::weak_ptr<const config_value> value;
+            size_t hash;
+        };
+
+        // returns the stored value equal to v, storing it if there isn't one, and its hash
+        shared_value intern(shared_value const& v, size_t& hash);
+        shared_value find_or_add(shared_value v, size_t hash);
+        // drops entries for values no generation uses any more
+        void purge();
+
+        size_t _capacity;
+        uint64_t _next_generation;
+        std::deque<shared_config> _generations;
+        // stored values by hash, and the hash of each stored value by address
+        std::unordered_multimap<size_t, std::weak_ptr<const config_value>> _by_hash;
+        std::unordered_map<config_value const*, interned> _by_address;
+    };
+
+}  // namespace hocon
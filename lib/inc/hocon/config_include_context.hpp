@@ -19,7 +19,6 @@ namespace hocon {
      */
     class config_include_context {
     public:
-        config_include_context() : _cur_dir(new std::string("")) {}
         /**
          * Tries to find a name relative to whatever is doing the including, for
          * example in the same directory as the file doing the including. Returns
@@ -47,16 +46,12 @@ namespace hocon {
          */
         virtual config_parse_options parse_options() const = 0;
 
-        void set_cur_dir(std::string dir) const {
-            _cur_dir->assign(dir);
-        }
-
-        std::string get_cur_dir() const {
-            return *_cur_dir;
-        }
-
-    protected:
-        std::shared_ptr<std::string> _cur_dir;
+        /**
+         * The directory of the resource doing the including, ending in a
+         * separator, or empty if it isn't in a directory. It's fixed when the
+         * resource is created, so contexts can be shared between threads.
+         */
+        virtual std::string get_cur_dir() const = 0;
     };
 
 }  // namespace hocon
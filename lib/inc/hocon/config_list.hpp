@@ -1,6 +1,8 @@
 #pragma once
 
 #include "types.hpp"
+#include <cstddef>
+#include <iterator>
 #include <vector>
 
 namespace hocon {
@@ -36,8 +38,53 @@ namespace hocon {
     public:
         config_list(shared_origin origin) : config_value(move(origin)) {}
 
+        /**
+         * Iterates over the elements of a list. Lists that store their elements
+         * hand out references to them; packed lists make each element when it's
+         * read, and the reference is good until the iterator moves or is
+         * destroyed, so a packed list isn't unpacked by iterating over it.
+         */
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = shared_value;
+            using difference_type = std::ptrdiff_t;
+            using pointer = shared_value const*;
+            using reference = shared_value const&;
+
+            iterator() = default;
+            iterator(config_list const* list, shared_value const* elements, size_t index) :
+                _list(list), _elements(elements), _index(index) {}
+
+            reference operator*() const {
+                if (_elements) {
+                    return _elements[_index];
+                }
+                if (!_current) {
+                    _current = _list->get(_index);
+                }
+                return _current;
+            }
+            pointer operator->() const { return &**this; }
+
+            iterator& operator++() { ++_index; _current = nullptr; return *this; }
+            iterator operator++(int) { auto old = *this; ++*this; return old; }
+            iterator operator+(difference_type n) const { return iterator(_list, _elements, _index + n); }
+            difference_type operator-(iterator const& other) const {
+                return static_cast<difference_type>(_index) - static_cast<difference_type>(other._index);
+            }
+
+            bool operator==(iterator const& other) const { return _list == other._list && _index == other._index; }
+            bool operator!=(iterator const& other) const { return !(*this == other); }
+
+        private:
+            config_list const* _list = nullptr;
+            shared_value const* _elements = nullptr;
+            size_t _index = 0;
+            mutable shared_value _current;
+        };
+
         // list interface
-        using iterator = std::vector<shared_value>::const_iterator;
         virtual bool is_empty() const = 0;
         virtual size_t size() const = 0;
         virtual shared_value operator[](size_t index) const = 0;
@@ -45,5 +92,17 @@ namespace hocon {
         virtual iterator begin() const = 0;
         virtual iterator end() const = 0;
         virtual unwrapped_value unwrapped() const = 0;
+
+        /**
+         * If the list is stored as a packed array of integers, returns a view of
+         * it without creating the elements; otherwise returns an empty view.
+         */
+        virtual array_view<int64_t> packed_longs() const { return {}; }
+
+        /**
+         * If the list is stored as a packed array of doubles, returns a view of
+         * it without creating the elements; otherwise returns an empty view.
+         */
+        virtual array_view<double> packed_doubles() const { return {}; }
     };
 }  // namespace hocon
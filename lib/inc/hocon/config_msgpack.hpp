@@ -0,0 +1,45 @@
+#pragma once
+
+#include "types.hpp"
+#include <string>
+
+namespace hocon {
+
+    /**
+     * Converts resolved values to and from <a href="https://msgpack.org">MessagePack</a>,
+     * for passing configs between processes without rendering and parsing them
+     * again. Objects, lists and scalars map to the MessagePack types of the same
+     * shape; integers keep their exact value and floating point numbers are
+     * stored as doubles.
+     *
+     * <p>
+     * When origins are included, each value that starts on a different line
+     * than the one before it is preceded by an extension (type 1, four byte
+     * big-endian line number), so decoded values report the same line numbers.
+     * Other origin details such as comments aren't kept.
+     */
+    class config_msgpack {
+    public:
+        /**
+         * Encodes a value.
+         *
+         * @param value a resolved value
+         * @param with_origins whether to include the line number of each value
+         * @return the encoded bytes
+         * @throws not_resolved_exception if the value hasn't been resolved
+         */
+        static std::string encode(shared_value const& value, bool with_origins = false);
+
+        /**
+         * Decodes a value created by encode, or any MessagePack document whose
+         * maps have string keys.
+         *
+         * @param bytes the encoded value
+         * @param origin_description description used for the origins of the decoded values
+         * @return the decoded value
+         * @throws parse_exception if the bytes aren't a single valid MessagePack value
+         */
+        static shared_value decode(std::string const& bytes, std::string origin_description = "msgpack");
+    };
+
+}  // namespace hocon
@@ -124,15 +124,95 @@ namespace hocon {
          */
         shared_includer const& get_includer() const;
 
+        /**
+         * Set a {@link config_source_provider} to read files and their includes
+         * from. null means to read them from the filesystem.
+         *
+         * @param provider the source provider to use or null for the filesystem
+         * @return new version of the parse options with a different source provider
+         */
+        config_parse_options set_source_provider(shared_source_provider provider) const;
+
+        /**
+         * Gets the current source provider (will be null for the filesystem).
+         * @return current source provider or null
+         */
+        shared_source_provider const& get_source_provider() const;
+
+        /**
+         * Set whether the bodies of objects are parsed the first time they're
+         * used rather than up front. Loading then costs little more than finding
+         * the matching braces of the objects that aren't used. The values are
+         * the same either way, except that syntax errors inside an object body
+         * are reported when the object is first used.
+         *
+         * <p>
+         * Documents with substitutions, includes or += are always parsed up
+         * front, since resolving them needs every value.
+         *
+         * @param lazy true to parse object bodies on first use
+         * @return new version of the parse options with lazy parsing set
+         */
+        config_parse_options set_lazy(bool lazy) const;
+
+        /**
+         * Gets whether object bodies are parsed on first use.
+         * @return true if object bodies are parsed on first use
+         */
+        bool get_lazy() const;
+
+        /**
+         * Set how many threads build values from a parsed document. With more
+         * than one, the values of large fields of the root object are built on
+         * that many threads at once, then merged in document order, so the
+         * result and any error are the same as with one. Fields that contain
+         * includes are always built on the calling thread. Inputs of 4MB or
+         * more are also tokenized on that many threads, at the cost of a
+         * second copy of the input in memory.
+         *
+         * @param threads the number of threads, or 0 for one per hardware thread
+         * @return new version of the parse options with the thread count set
+         */
+        config_parse_options set_parse_threads(unsigned threads) const;
+
+        /**
+         * Gets how many threads build values from a parsed document; 1 by default.
+         * @return the number of threads, or 0 for one per hardware thread
+         */
+        unsigned get_parse_threads() const;
+
+        /**
+         * Set a {@link config_budget} that limits the work parsing may do,
+         * including parsing included files. null means no limits.
+         *
+         * @param budget the budget to count against or null for none
+         * @return new version of the parse options with the budget set
+         */
+        config_parse_options set_budget(shared_budget budget) const;
+
+        /**
+         * Gets the current budget (will be null for no limits).
+         * @return the current budget or null
+         */
+        shared_budget const& get_budget() const;
+
     private:
         config_parse_options(shared_string origin_desc,
                              bool allow_missing, shared_includer includer,
-                             config_syntax syntax = config_syntax::UNSPECIFIED);
+                             config_syntax syntax = config_syntax::UNSPECIFIED,
+                             shared_source_provider source_provider = nullptr,
+                             bool lazy = false,
+                             unsigned parse_threads = 1,
+                             shared_budget budget = nullptr);
         config_parse_options with_fallback_origin_description(shared_string origin_description) const;
 
         config_syntax _syntax;
         shared_string _origin_description;
         bool _allow_missing;
         shared_includer _includer;
+        shared_source_provider _source_provider;
+        bool _lazy;
+        unsigned _parse_threads;
+        shared_budget _budget;
     };
 }  // namespace hocon
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * An index of the paths to every leaf value in a resolved config, for
+     * answering prefix queries like "which keys are under <code>features</code>"
+     * without walking the objects. It's a trie on path elements laid out
+     * breadth-first in one array, so each node's children are contiguous and
+     * sorted; each distinct key is stored once.
+     *
+     * <p>
+     * Leaves are the same as for {@link config#entry_set()}: any value that
+     * isn't an object or null. Like config, the index is immutable and safe to
+     * share between threads.
+     */
+    class config_path_index {
+    public:
+        /**
+         * Builds the index. Throws not_resolved_exception if the config
+         * isn't resolved.
+         */
+        explicit config_path_index(config const& conf);
+
+        /**
+         * True if the path is a leaf or has a leaf somewhere under it.
+         * The empty string means the whole config.
+         */
+        bool has_prefix(std::string const& path_expression) const;
+
+        /**
+         * The number of leaves at or under the path. Finding the path takes a
+         * binary search of the children at each level, so O(depth · log
+         * fanout); the count itself is stored.
+         */
+        size_t count(std::string const& path_expression) const;
+
+        /**
+         * The rendered paths of the leaves at or under the path, in sorted key
+         * order; the time taken depends only on the size of the result.
+         */
+        std::vector<std::string> paths_with_prefix(std::string const& path_expression) const;
+
+        /** Approximate number of bytes used by the index. */
+        size_t memory_usage() const;
+
+    private:
+        struct node {
+            uint32_t key;
+            uint32_t first_child;
+            uint32_t child_count;
+            uint32_t leaf_count;
+        };
+
+        // returns the index of the node for the path, or -1 if there isn't one
+        int64_t find(std::string const& path_expression) const;
+
+        void collect(uint32_t index, std::vector<std::string>& elements, std::vector<std::string>& result) const;
+
+        std::vector<node> _nodes;
+        std::vector<std::string> _keys;
+    };
+
+}  // namespace hocon
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "types.hpp"
+#include "config_resolve_options.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace hocon {
+
+    /**
+     * Remembers the results of resolving configs, so resolving a config equal
+     * to one resolved before gives back the earlier result instead of
+     * resolving it again. Configs are compared by structure: keys, values and
+     * substitutions, but not origins, so a result keeps the origins of the
+     * config it was first resolved for. Configs without substitutions are
+     * cached too, so identical ones end up sharing one instance.
+     *
+     * <p>
+     * Only whole configs are cached. Two configs that differ anywhere miss
+     * each other's results, and their identical subtrees are resolved again
+     * rather than shared.
+     *
+     * <p>
+     * Use a cache by passing it to {@link config_resolve_options#set_cache};
+     * only resolving a config against itself, as {@link config#resolve} does,
+     * goes through the cache. The least recently used results are dropped
+     * when it's full. It's safe to share a cache between threads.
+     */
+    class config_resolve_cache {
+    public:
+        struct statistics {
+            uint64_t hits;
+            uint64_t misses;
+            size_t entries;
+            /** Approximate bytes held by the cached configs, before and after resolving. */
+            size_t memory_usage;
+        };
+
+        /** Creates a cache holding at most max_entries results. */
+        explicit config_resolve_cache(size_t max_entries = 1024);
+
+        statistics stats() const;
+
+        /** Drops every cached result; the statistics are kept. */
+        void clear();
+
+        /**
+         * Returns the cached result of resolving root with options, or calls
+         * resolve and caches what it returns.
+         */
+        shared_value find_or_resolve(shared_value const& root, config_resolve_options const& options,
+                                     std::function<shared_value()> const& resolve);
+
+        /** A hash of a value's structure, ignoring origins. */
+        static size_t structural_hash(shared_value const& v);
+
+        /** True if two values have the same structure, ignoring origins. */
+        static bool structurally_equal(shared_value const& a, shared_value const& b);
+
+    private:
+        struct entry {
+            size_t hash;
+            bool use_system_environment;
+            bool allow_unresolved;
+            shared_value unresolved;
+            shared_value resolved;
+            size_t memory_usage;
+        };
+
+        using entry_list = std::list<entry>;
+
+        entry_list::iterator find(size_t hash, shared_value const& root, config_resolve_options const& options);
+
+        size_t _max_entries;
+        mutable std::mutex _mutex;
+        // most recently used first
+        entry_list _entries;
+        std::unordered_multimap<size_t, entry_list::iterator> _by_hash;
+        uint64_t _hits;
+        uint64_t _misses;
+        size_t _memory_usage;
+    };
+
+}  // namespace hocon
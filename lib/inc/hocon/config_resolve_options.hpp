@@ -1,6 +1,12 @@
 #pragma once
 
+#include "types.hpp"
+
+#include <memory>
+
 namespace hocon {
+    class config_resolve_cache;
+
     class config_resolve_options {
     public:
         /**
@@ -9,7 +15,8 @@ namespace hocon {
          *
          * @return the default resolve options
          */
-        config_resolve_options(bool use_system_environment = true, bool allow_unresolved = false);
+        config_resolve_options(bool use_system_environment = true, bool allow_unresolved = false,
+                               std::shared_ptr<config_resolve_cache> cache = nullptr, shared_budget budget = nullptr);
 
         /**
          * Returns resolve options that disable any reference to "system" data
@@ -49,8 +56,46 @@ namespace hocon {
          */
         bool get_allow_unresolved() const;
 
+        /**
+         * Returns options that look up the result of resolving a whole config
+         * in the given cache before resolving it, and store it there after. A
+         * cache can be shared by any number of resolves, across threads.
+         *
+         * @param cache
+         *            the cache to use, or null to resolve without one
+         * @return options using the cache
+         */
+        config_resolve_options set_cache(std::shared_ptr<config_resolve_cache> cache) const;
+
+        /**
+         * Returns the cache resolves go through, or null if there isn't one.
+         *
+         * @return the resolve cache
+         */
+        std::shared_ptr<config_resolve_cache> const& get_cache() const;
+
+        /**
+         * Returns options that count substitutions looked up, and values built
+         * by concatenating, against the given budget, throwing
+         * budget_exceeded_exception when it runs out.
+         *
+         * @param budget
+         *            the budget to count against, or null for no limits
+         * @return options using the budget
+         */
+        config_resolve_options set_budget(shared_budget budget) const;
+
+        /**
+         * Returns the budget resolves count against, or null if there isn't one.
+         *
+         * @return the resolve budget
+         */
+        shared_budget const& get_budget() const;
+
     private:
         bool _use_system_environment;
         bool _allow_unresovled;
+        std::shared_ptr<config_resolve_cache> _cache;
+        shared_budget _budget;
     };
 }  // namespace hocon
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "config.hpp"
+#include "config_parse_options.hpp"
+#include "types.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * The type-erased form of a config_schema: how to store one kind of value
+     * into a C++ object reached through a void pointer. Built by config_schema;
+     * there's no need to use it directly.
+     */
+    class schema_node {
+    public:
+        enum class kind { BOOLEAN, INT, LONG, DOUBLE, STRING, OBJECT, LIST };
+
+        explicit schema_node(kind k) : _kind(k) {}
+
+        static std::shared_ptr<const schema_node> of(bool const*) { return scalar(kind::BOOLEAN); }
+        static std::shared_ptr<const schema_node> of(int const*) { return scalar(kind::INT); }
+        static std::shared_ptr<const schema_node> of(int64_t const*) { return scalar(kind::LONG); }
+        static std::shared_ptr<const schema_node> of(double const*) { return scalar(kind::DOUBLE); }
+        static std::shared_ptr<const schema_node> of(std::string const*) { return scalar(kind::STRING); }
+
+        template<typename E>
+        static std::shared_ptr<const schema_node> of(std::vector<E> const*) {
+            return list_of<E>(of(static_cast<E const*>(nullptr)));
+        }
+
+        template<typename E>
+        static std::shared_ptr<const schema_node> list_of(std::shared_ptr<const schema_node> element) {
+            auto node = std::make_shared<schema_node>(kind::LIST);
+            node->_element = std::move(element);
+            node->_clear = [](void* list) { static_cast<std::vector<E>*>(list)->clear(); };
+            node->_append = [](void* list) -> void* {
+                auto& v = *static_cast<std::vector<E>*>(list);
+                v.emplace_back();
+                return &v.back();
+            };
+            return node;
+        }
+
+        /** One key of an object and how to get to its member. */
+        struct field {
+            std::string key;
+            std::shared_ptr<const schema_node> node;
+            std::function<void*(void*)> member;
+        };
+
+        void add_field(std::string key, std::shared_ptr<const schema_node> node, std::function<void*(void*)> member) {
+            _fields.push_back({ std::move(key), std::move(node), std::move(member) });
+        }
+
+        kind get_kind() const { return _kind; }
+        std::vector<field> const& fields() const { return _fields; }
+        field const* find_field(std::string const& key) const;
+        schema_node const& element() const { return *_element; }
+        void clear(void* list) const { _clear(list); }
+        void* append(void* list) const { return _append(list); }
+
+        /**
+         * Stores a resolved value into target. Missing and null values leave
+         * their members unchanged.
+         *
+         * @throws wrong_type_exception if a value can't be converted to its member's type
+         */
+        void fill(shared_value const& value, void* target, std::string const& path) const;
+
+        /**
+         * Stores the input straight from its tokens, without building a config,
+         * and returns true; or returns false, possibly after storing some of it,
+         * if the input needs the full parser: it has substitutions, includes,
+         * += or value concatenations, a value needs converting to its member's
+         * type, or it has any error.
+         */
+        bool parse_direct(std::string const& text, config_parse_options const& options, void* target) const;
+        bool parse_file_direct(std::string const& path, config_parse_options const& options, void* target) const;
+
+    private:
+        static std::shared_ptr<const schema_node> scalar(kind k) { return std::make_shared<schema_node>(k); }
+
+        kind _kind;
+        std::vector<field> _fields;
+        std::shared_ptr<const schema_node> _element;
+        std::function<void(void*)> _clear;
+        std::function<void*(void*)> _append;
+    };
+
+    /**
+     * Describes how to load a config into a struct of type T, which must be
+     * default constructible. Members can be bool, int, int64_t, double,
+     * std::string, vectors of those, or structs and vectors of structs that
+     * have their own schema:
+     *
+     * <pre>
+     *   struct route { std::string prefix; int weight = 1; };
+     *   struct table { std::string name; std::vector&lt;route&gt; routes; };
+     *
+     *   config_schema&lt;route&gt; route_schema;
+     *   route_schema.field("prefix", &amp;route::prefix).field("weight", &amp;route::weight);
+     *   config_schema&lt;table&gt; table_schema;
+     *   table_schema.field("name", &amp;table::name).field("routes", &amp;table::routes, route_schema);
+     *
+     *   table t = table_schema.parse_file("routes.json");
+     * </pre>
+     *
+     * <p>
+     * Keys not in the schema are ignored, and members whose keys are missing or
+     * null keep their default values. Values are converted the way the typed
+     * getters of {@link config} convert them.
+     *
+     * <p>
+     * Inputs without substitutions, includes, += or value concatenations whose
+     * values already have their members' types are stored straight from the
+     * tokenizer, without building a config. Anything else is parsed and
+     * resolved as usual and then stored, so the result is the same either way.
+     */
+    template<typename T>
+    class config_schema {
+    public:
+        config_schema() : _node(std::make_shared<schema_node>(schema_node::kind::OBJECT)) {}
+
+        /** Adds a scalar member, or a vector of scalars. */
+        template<typename M>
+        config_schema& field(std::string key, M T::* member) {
+            _node->add_field(std::move(key), schema_node::of(static_cast<M const*>(nullptr)), accessor(member));
+            return *this;
+        }
+
+        /** Adds a struct member with its own schema. */
+        template<typename M>
+        config_schema& field(std::string key, M T::* member, config_schema<M> const& schema) {
+            _node->add_field(std::move(key), schema.node(), accessor(member));
+            return *this;
+        }
+
+        /** Adds a vector of structs with their own schema. */
+        template<typename E>
+        config_schema& field(std::string key, std::vector<E> T::* member, config_schema<E> const& schema) {
+            _node->add_field(std::move(key), schema_node::list_of<E>(schema.node()), accessor(member));
+            return *this;
+        }
+
+        T parse_string(std::string const& s, config_parse_options options = config_parse_options()) const {
+            T result{};
+            if (!_node->parse_direct(s, options, &result)) {
+                result = T{};
+                _node->fill(config::parse_string(s, options)->resolve()->root(), &result, "");
+            }
+            return result;
+        }
+
+        T parse_file(std::string const& path, config_parse_options options = config_parse_options()) const {
+            T result{};
+            if (!_node->parse_file_direct(path, options, &result)) {
+                result = T{};
+                _node->fill(config::parse_file_any_syntax(path, options)->resolve()->root(), &result, "");
+            }
+            return result;
+        }
+
+        /** Stores an already loaded config. */
+        T from_config(shared_config const& conf) const {
+            T result{};
+            _node->fill(conf->root(), &result, "");
+            return result;
+        }
+
+        std::shared_ptr<const schema_node> node() const { return _node; }
+
+    private:
+        template<typename M>
+        static std::function<void*(void*)> accessor(M T::* member) {
+            return [member](void* target) -> void* { return &(static_cast<T*>(target)->*member); };
+        }
+
+        std::shared_ptr<schema_node> _node;
+    };
+
+}  // namespace hocon
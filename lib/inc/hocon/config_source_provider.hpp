@@ -0,0 +1,98 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace hocon {
+
+    class config_bundle;
+
+    /**
+     * The bytes of a source, and whatever owns them; the bytes stay valid as
+     * long as the owner is held.
+     */
+    struct config_source {
+        array_view<char> bytes;
+        std::shared_ptr<const void> owner;
+    };
+
+    /**
+     * Where files and the files they include are read from. Set one with
+     * {@link config_parse_options#set_source_provider}; names are the paths the
+     * parser would otherwise open, relative to the working directory or to the
+     * including file as usual.
+     *
+     * <p>
+     * Implementations must be safe to call from multiple threads.
+     */
+    class config_source_provider {
+    public:
+        virtual ~config_source_provider() = default;
+
+        /**
+         * Looks up a source by name.
+         * @param name the path of the source
+         * @param source set to the source's bytes if it's found
+         * @return false if there is no such source
+         */
+        virtual bool open(std::string const& name, config_source& source) const = 0;
+
+        /** Reads files from the filesystem, as when no provider is set. */
+        static shared_source_provider filesystem();
+
+        /**
+         * Serves sources from memory without copying them when they're read.
+         * Names are matched after resolving "." and ".." elements.
+         */
+        static shared_source_provider in_memory(std::unordered_map<std::string, std::string> sources);
+
+        /**
+         * Serves the files in a bundle. Names not in the bundle are read from
+         * the filesystem relative to the bundle's directory.
+         */
+        static shared_source_provider bundle(std::shared_ptr<const config_bundle> bundle);
+    };
+
+    /**
+     * Reads sources ahead of the parser on a pool of threads, so that loading
+     * a tree of includes waits on one read at a time at most rather than one
+     * after another. Sources are read ahead when they're named up front, say
+     * from a manifest or from {@link #opened} of a previous load, and when an
+     * include of them is found by scanning a source as it's read; the parser
+     * then parses one source while the sources it includes are being read.
+     *
+     * <p>
+     * Sources that weren't read ahead are read when they're opened. If reading
+     * a source throws, opening it throws the same exception.
+     */
+    class prefetching_source_provider : public config_source_provider {
+    public:
+        /**
+         * @param names sources to start reading right away
+         * @param fallback where sources are read from
+         * @param threads how many sources are read at once
+         */
+        explicit prefetching_source_provider(std::vector<std::string> const& names,
+                                             shared_source_provider fallback = filesystem(),
+                                             unsigned threads = 8);
+        ~prefetching_source_provider() override;
+
+        bool open(std::string const& name, config_source& source) const override;
+
+        /** Starts reading the named sources, unless they've already been read or started. */
+        void prefetch(std::vector<std::string> const& names) const;
+
+        /** The names of the sources opened so far, in the order they were first opened. */
+        std::vector<std::string> opened() const;
+
+    private:
+        struct state;
+        std::shared_ptr<state> _state;
+        std::vector<std::thread> _workers;
+    };
+
+}  // namespace hocon
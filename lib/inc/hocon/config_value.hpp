@@ -11,6 +11,7 @@
 namespace hocon {
 
     class unmergeable;
+    class config_value_visitor;
     class resolve_source;
     class resolve_context;
 
@@ -93,6 +94,15 @@ namespace hocon {
 
         virtual unwrapped_value unwrapped() const = 0;
 
+        /**
+         * Reports this value and everything below it to the visitor, depth first.
+         * Packed lists report their elements without creating them.
+         *
+         * @param visitor receives the contents of the value
+         * @throws not_resolved_exception if the value hasn't been resolved
+         */
+        virtual void accept(config_value_visitor& visitor) const;
+
         /**
          * Renders the config value as a HOCON string. This method is primarily
          * intended for debugging, so it tries to add helpful comments and
@@ -210,6 +220,9 @@ namespace hocon {
         class modifier {
          public:
             virtual shared_value modify_child_may_throw(std::string const& key_or_null, shared_value v) = 0;
+
+            /** True if the modifier gave up and the remaining children should not be visited. */
+            virtual bool stopped() const { return false; }
         };
 
         class no_exceptions_modifier : public modifier {
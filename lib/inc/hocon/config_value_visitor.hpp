@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace hocon {
+
+    /**
+     * Receives the contents of a resolved value tree depth first; pass one to
+     * {@link config_value#accept} to build another representation of a config
+     * in a single pass, without going through {@link config_value#unwrapped}.
+     *
+     * <p>
+     * An object is reported as begin_object, then a key followed by its value
+     * for each entry, then end_object; a list as begin_list, its elements and
+     * end_list. The sizes passed to begin_object and begin_list are the exact
+     * number of entries that follow, so they can be used to reserve space.
+     * Object keys are reported in no particular order.
+     */
+    class config_value_visitor {
+    public:
+        virtual ~config_value_visitor() = default;
+
+        virtual void begin_object(size_t size) = 0;
+        virtual void key(std::string const& key) = 0;
+        virtual void end_object() = 0;
+
+        virtual void begin_list(size_t size) = 0;
+        virtual void end_list() = 0;
+
+        virtual void null_value() = 0;
+        virtual void boolean_value(bool value) = 0;
+        virtual void long_value(int64_t value) = 0;
+        virtual void double_value(double value) = 0;
+        virtual void string_value(std::string const& value) = 0;
+    };
+
+}  // namespace hocon
@@ -14,6 +14,20 @@ namespace hocon {
      */
     using duration = std::pair<int64_t, int>;
 
+    /**
+     * A read-only view of a contiguous array owned by the object that returned
+     * it. It stays valid as long as that object.
+     */
+    template <typename T>
+    struct array_view {
+        T const* data = nullptr;
+        size_t size = 0;
+
+        T const* begin() const { return data; }
+        T const* end() const { return data + size; }
+        bool empty() const { return size == 0; }
+    };
+
     class config;
     using shared_config = std::shared_ptr<const config>;
 
@@ -52,4 +66,10 @@ namespace hocon {
 
     class config_parseable;
     using shared_parseable = std::shared_ptr<const config_parseable>;
+
+    class config_source_provider;
+    using shared_source_provider = std::shared_ptr<const config_source_provider>;
+
+    class config_budget;
+    using shared_budget = std::shared_ptr<config_budget>;
 }  // namespace hocon
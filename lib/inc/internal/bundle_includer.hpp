@@ -0,0 +1,36 @@
+#pragma once
+
+#include <hocon/config_bundle.hpp>
+#include <internal/full_includer.hpp>
+
+#include <string>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * Includer that reads includes from a config_bundle, relative to the
+     * including file's directory in the bundle. Includes the bundle doesn't
+     * have go to the fallback includer.
+     */
+    class bundle_includer : public full_includer, public std::enable_shared_from_this<bundle_includer> {
+    public:
+        bundle_includer(std::shared_ptr<const config_bundle> bundle, shared_includer fallback);
+
+        shared_includer with_fallback(shared_includer fallback) const override;
+
+        shared_object include(shared_include_context context, std::string what) const override;
+
+        shared_object include_file(shared_include_context context, std::string what) const override;
+
+    private:
+        /** The bundled files an include of what refers to, in the order they're merged. */
+        std::vector<std::string> find_in_bundle(shared_include_context const& context, std::string const& what) const;
+
+        shared_object parse_all(shared_include_context const& context, std::vector<std::string> const& paths) const;
+
+        std::shared_ptr<const config_bundle> _bundle;
+        shared_includer _fallback;
+    };
+
+}  // namespace hocon
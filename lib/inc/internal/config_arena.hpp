@@ -0,0 +1,77 @@
+#pragma once
+
+#include <hocon/types.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * A bump allocator for frozen copies of resolved configs. Memory is
+     * handed out in allocation order from large blocks, and only released when
+     * the arena is, which happens when the last value allocated from it is
+     * destroyed.
+     */
+    class config_arena {
+    public:
+        explicit config_arena(size_t block_size = 64 * 1024);
+
+        void* allocate(size_t bytes, size_t alignment);
+
+        /** Bytes handed out so far, including alignment padding. */
+        size_t bytes_used() const { return _used; }
+
+        /**
+         * Copies a resolved tree into an arena that's never freed, each value
+         * next to its reference counts, right after its children. The
+         * pointers between the copied values, and the one returned, share no
+         * ownership, so copying them doesn't write to the arena. The keys and
+         * origins the values hold aren't in the arena, and values that can't
+         * be copied are shared with the original. Lists are
+         * copied unpacked, since reading a packed one makes its elements and
+         * counts references to their origins, and strings don't keep their
+         * coercions, which would fill themselves in when first read.
+         */
+        static shared_object freeze(shared_object const& root);
+
+    private:
+        std::vector<std::unique_ptr<char[]>> _blocks;
+        size_t _block_size;
+        char* _next;
+        char* _end;
+        size_t _used;
+    };
+
+    /** Allocates from a config_arena, keeping it alive as long as anything allocated from it is. */
+    template <typename T>
+    class arena_allocator {
+    public:
+        using value_type = T;
+
+        explicit arena_allocator(std::shared_ptr<config_arena> arena) : _arena(std::move(arena)) {}
+
+        template <typename U>
+        arena_allocator(arena_allocator<U> const& other) : _arena(other._arena) {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t) {}
+
+        template <typename U>
+        bool operator==(arena_allocator<U> const& other) const { return _arena == other._arena; }
+
+        template <typename U>
+        bool operator!=(arena_allocator<U> const& other) const { return _arena != other._arena; }
+
+    private:
+        template <typename U>
+        friend class arena_allocator;
+
+        std::shared_ptr<config_arena> _arena;
+    };
+
+}  // namespace hocon
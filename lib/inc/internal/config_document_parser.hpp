@@ -21,7 +21,8 @@ namespace hocon { namespace config_document_parser {
 
     class parse_context {
     public:
-        parse_context(config_syntax flavor, shared_origin origin, token_iterator tokens);
+        parse_context(config_syntax flavor, shared_origin origin, token_iterator tokens,
+                      shared_budget budget = nullptr);
 
         std::shared_ptr<config_node_root> parse();
 
@@ -77,6 +78,10 @@ namespace hocon { namespace config_document_parser {
         // used to modify the error message to reflect that
         // someone may think this is .properties format.
         int _equals_count;
+
+        // counts tokens and nesting when there are limits on them
+        shared_budget _budget;
+        size_t _depth;
     };
 
 
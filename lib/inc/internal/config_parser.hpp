@@ -24,6 +24,9 @@ namespace hocon { namespace config_parser {
             config_parse_options options,
             shared_include_context include_context);
 
+    class object_builder;
+    struct pending_field;
+
     class parse_context {
         int _line_number;
         std::shared_ptr<const config_node_root> _document;
@@ -32,22 +35,27 @@ namespace hocon { namespace config_parser {
         config_syntax _flavor;
         shared_origin _base_origin, _line_origin;
         std::vector<path> _path_stack;
+        unsigned _threads;
+        shared_budget _budget;
 
     public:
         parse_context(config_syntax flavor, shared_origin origin, std::shared_ptr<const config_node_root> document,
-                std::shared_ptr<const full_includer> includer, shared_include_context include_context);
+                std::shared_ptr<const full_includer> includer, shared_include_context include_context,
+                unsigned threads = 1, shared_budget budget = nullptr);
 
         shared_value parse();
 
         int array_count;
 
     private:
-        static shared_object create_value_under_path(path p, shared_value value);
         shared_origin line_origin() const;
         path full_current_path() const;
         shared_value parse_value(shared_node_value n, std::vector<std::string>& comments);
-        void parse_include(std::unordered_map<std::string, shared_value> &values, std::shared_ptr<const config_node_include> n);
+        shared_object parse_include(std::shared_ptr<const config_node_include> n);
         shared_object parse_object(shared_node_object n);
+        shared_object parse_object_in_parallel(shared_node_object n);
+        void parse_fields(shared_node_object const& n, object_builder& values, std::vector<pending_field>* pending);
+        void merge_field(object_builder& values, path const& field_path, shared_value value, int line) const;
         shared_value parse_array(shared_node_array n);
         shared_value parse_concatenation(shared_node_concatenation n);
     };
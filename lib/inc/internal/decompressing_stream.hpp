@@ -0,0 +1,37 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace hocon {
+
+    /** Compression formats that files can be read from transparently. */
+    enum class compression { NONE, GZIP, ZSTD };
+
+    /** The compression a file name's extension (.gz or .zst) implies. */
+    compression compression_from_extension(std::string const& name);
+
+    /** The name without its .gz or .zst extension, if it has one. */
+    std::string strip_compression_extension(std::string const& name);
+
+    /**
+     * The compression of a stream, from its magic bytes. Leaves the stream at
+     * its current position; the stream must be seekable.
+     */
+    compression detect_compression(std::istream& in);
+
+    /**
+     * Wraps in so reading from it gives the decompressed contents, inflated a
+     * chunk at a time as they're read. Streams that are neither named nor
+     * detected as compressed are returned as they are. Throws io_exception if
+     * this build doesn't support the format, or when reading corrupt data.
+     * @param in the stream to read from
+     * @param name the name of the source, for its extension and for errors
+     */
+    std::unique_ptr<std::istream> decompressing_stream(std::unique_ptr<std::istream> in, std::string const& name);
+
+    /** True if this build can read the given compression. */
+    bool compression_supported(compression format);
+
+}  // namespace hocon
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <hocon/config_parse_options.hpp>
+#include <hocon/types.hpp>
+
+#include <memory>
+#include <string>
+
+namespace hocon { namespace lazy_parser {
+
+    /**
+     * Parses a document like config_parser, except that the bodies of objects
+     * that are values of the root object are parsed the first time they're used,
+     * and their own object values in turn. A first pass only matches braces,
+     * following the tokenizer's rules for strings and comments; the rest of the
+     * document is parsed with each deferred body left empty, so everything else
+     * is parsed, and reported, the same as usual.
+     *
+     * Returns null if the document should be parsed up front instead: it has
+     * substitutions, includes or +=, which need every value to resolve, or the
+     * first pass can't tell where its objects are.
+     *
+     * owner is kept alive as long as a deferred body may still be parsed, since
+     * include_context may refer to it.
+     */
+    shared_value parse(std::shared_ptr<const std::string> text,
+                       shared_origin origin,
+                       config_parse_options options,
+                       shared_include_context include_context,
+                       std::shared_ptr<const void> owner);
+
+}}  // namespace hocon::lazy_parser
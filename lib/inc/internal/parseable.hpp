@@ -4,10 +4,12 @@
 #include <internal/simple_config_origin.hpp>
 #include <hocon/config_object.hpp>
 #include <hocon/config_include_context.hpp>
+#include <hocon/config_bundle.hpp>
 
 namespace hocon {
 
     class config_document;
+    class token_iterator;
 
     class parseable : public config_parseable, public std::enable_shared_from_this<parseable> {
     public:
@@ -26,6 +28,12 @@ namespace hocon {
 
         shared_value parse_value() const;
 
+        /**
+         * Tokenizes the input the same way parse does, for callers that build
+         * something other than a config from the tokens.
+         */
+        token_iterator tokens(config_parse_options const& options) const;
+
         config_parse_options const& options() const override;
         std::shared_ptr<const config_origin> origin() const override;
 
@@ -38,8 +46,7 @@ namespace hocon {
         virtual std::shared_ptr<config_parseable> relative_to(std::string file_name) const;
 
         std::string to_string() const;
-        std::string get_cur_dir() const;
-        void set_cur_dir(std::string dir) const;
+        std::string const& get_cur_dir() const { return _cur_dir; }
         void separate_filepath(const std::string& path, std::string* file_dir,
                                 std::string* file_name) const;
 
@@ -48,6 +55,10 @@ namespace hocon {
         parseable(parseable const&) = delete;
         parseable& operator=(parseable const&) = delete;
 
+    protected:
+        // only called by constructors; a parseable doesn't change once it's constructed
+        void set_cur_dir(std::string dir) { _cur_dir = std::move(dir); }
+
     private:
         std::shared_ptr<config_document> parse_document(config_parse_options const& base_options) const;
         std::shared_ptr<config_document> parse_document(shared_origin origin,
@@ -66,11 +77,10 @@ namespace hocon {
 
         config_parse_options fixup_options(config_parse_options const& base_options) const;
 
-        std::vector<parseable> _parse_stack;
-
         shared_origin _initial_origin;
         config_parse_options _initial_options;
         shared_include_context _include_context;
+        std::string _cur_dir;
 
         static const int MAX_INCLUDE_DEPTH;
     };
@@ -96,6 +106,23 @@ namespace hocon {
         std::string _input;
     };
 
+    /** A file in a config_bundle, read in place from the bundle's memory. */
+    class parseable_bundle_entry : public parseable {
+    public:
+        parseable_bundle_entry(std::shared_ptr<const config_bundle> bundle, std::string path,
+                               config_parse_options options);
+        std::unique_ptr<std::istream> reader() const override;
+        shared_origin create_origin() const override;
+        config_syntax guess_syntax() const override;
+
+        /** Looks in the bundle first, then on the filesystem next to the bundle. */
+        std::shared_ptr<config_parseable> relative_to(std::string file_name) const override;
+
+    private:
+        std::shared_ptr<const config_bundle> _bundle;
+        std::string _path;
+    };
+
     // NOTE: this is not a faithful port of the `ParseableResources` class from the
     // upstream, because at least for now we're not going to try to do anything
     // crazy like look for files on the ruby load path.  However, there is a decent
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <hocon/types.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * A blocked bloom filter over every path in a resolved config, leaves and
+     * the objects above them, for answering most lookups of missing paths
+     * without parsing the path expression. Each path sets a few bits in one
+     * 64-byte block, so a lookup touches one cache line.
+     *
+     * <p>
+     * Only paths whose keys are plain words (letters, digits, '_' and '-', not
+     * starting with a digit or '-') are stored, because only for those is the
+     * path expression the keys joined with '.'. Expressions that aren't of
+     * that form can't be answered from the filter.
+     */
+    class path_filter {
+    public:
+        static std::shared_ptr<const path_filter> build(shared_object const& root);
+
+        /** True if the expression is a plain path that the config definitely doesn't have. */
+        bool definitely_absent(std::string const& path_expression) const;
+
+        size_t memory_usage() const { return sizeof(*this) + _blocks.capacity() * sizeof(block); }
+
+    private:
+        struct block {
+            uint64_t words[8];
+        };
+
+        explicit path_filter(size_t paths);
+
+        void add(std::string const& path);
+        bool might_contain(std::string const& path) const;
+
+        static bool is_plain_key(std::string const& key);
+        static bool is_plain_expression(std::string const& path_expression);
+
+        std::vector<block> _blocks;
+    };
+
+}  // namespace hocon
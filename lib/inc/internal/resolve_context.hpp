@@ -18,7 +18,7 @@ namespace hocon {
         resolve_context(config_resolve_options options, path restrict_to_child, std::vector<shared_value> cycle_markers);
         resolve_context(config_resolve_options options, path restrict_to_child);
         bool is_restricted_to_child() const;
-        config_resolve_options options() const;
+        config_resolve_options const& options() const;
 
         resolve_result<shared_value> resolve(shared_value original, resolve_source const& source) const;
         path restrict_to_child() const;
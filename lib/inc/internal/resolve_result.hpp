@@ -7,10 +7,19 @@ namespace hocon {
     template<typename V>
     struct resolve_result {
         resolve_result(resolve_context c, V v) :
-            context(std::move(c)), value(std::move(v)) {}
+            context(std::move(c)), value(std::move(v)), possible(true) {}
 
         resolve_context context;
         V value;
+
+        /**
+         * False when the value could not be resolved because it is part of a
+         * cycle of substitutions. This is expected while resolving (a ${?foo}
+         * that refers back to itself simply drops out), so it is returned up to
+         * the enclosing config_reference rather than thrown; callers that get a
+         * result which is not possible must pass it on without using the value.
+         */
+        bool possible;
     };
 
     template<typename T>
@@ -18,4 +27,10 @@ namespace hocon {
         return resolve_result<shared_value>(std::move(context), std::move(value));
     }
 
+    static inline resolve_result<shared_value> make_not_possible_result(resolve_context context) {
+        resolve_result<shared_value> result(std::move(context), nullptr);
+        result.possible = false;
+        return result;
+    }
+
 }  // namespace hocon
@@ -38,6 +38,12 @@ namespace hocon {
         static shared_origin merge_origins(std::vector<shared_value> const& stack);
         static shared_origin merge_origins(std::vector<shared_origin> const& stack);
 
+        /**
+         * True if this origin is the same as other.with_line_number(line_number()),
+         * i.e. it differs from other only by being on a single line.
+         */
+        bool is_line_of(simple_config_origin const& other) const;
+
         bool operator==(const simple_config_origin &other) const;
         bool operator!=(const simple_config_origin &other) const;
 
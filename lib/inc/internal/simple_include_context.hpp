@@ -15,6 +15,7 @@ namespace hocon {
 
         shared_parseable relative_to(std::string file_name) const override;
         config_parse_options parse_options() const override;
+        std::string get_cur_dir() const override;
 
     private:
         parseable const& _parseable;
@@ -47,7 +47,8 @@ namespace hocon {
 
     class token_iterator : public iterator {
     public:
-        token_iterator(shared_origin origin, std::unique_ptr<std::istream> input, bool allow_comments);
+        token_iterator(shared_origin origin, std::unique_ptr<std::istream> input, bool allow_comments,
+                       int first_line_number = 1);
         token_iterator(shared_origin origin, std::unique_ptr<std::istream> input, config_syntax flavor);
 
         bool has_next() override;
@@ -55,7 +56,18 @@ namespace hocon {
 
         static std::string render(token_list tokens);
 
+        /**
+         * Tokenizes all of input up front, splitting it at newlines into chunks that
+         * are tokenized on up to `threads` threads. The tokens are the same as
+         * reading the input with a token_iterator; if any chunk fails, the
+         * returned iterator reads the input sequentially so errors are too.
+         */
+        static token_iterator tokenize_parallel(shared_origin origin, std::string input,
+                                                config_syntax flavor, unsigned threads);
+
     private:
+        token_iterator(shared_origin origin, bool allow_comments, token_list tokens);
+
         class whitespace_saver {
         public:
             whitespace_saver();
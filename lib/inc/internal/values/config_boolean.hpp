@@ -12,6 +12,7 @@ namespace hocon {
         std::string transform_to_string() const override;
 
         unwrapped_value unwrapped() const override;
+        void accept(config_value_visitor& visitor) const override;
 
         bool bool_value() const;
         bool operator==(config_value const& other) const override;
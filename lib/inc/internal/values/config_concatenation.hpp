@@ -28,6 +28,8 @@ namespace hocon {
         config_value::type value_type() const override;
         std::vector<shared_value> unmerged_values() const override;
 
+        std::vector<shared_value> const& pieces() const { return _pieces; }
+
         resolve_status get_resolve_status() const override;
 
         shared_value replace_child(shared_value const& child, shared_value replacement) const override;
@@ -14,6 +14,7 @@ namespace hocon {
         std::string transform_to_string() const override;
 
         unwrapped_value unwrapped() const override;
+        void accept(config_value_visitor& visitor) const override;
 
         int64_t long_value() const override;
         double double_value() const override;
@@ -22,6 +22,7 @@ namespace hocon {
         std::string transform_to_string() const override;
 
         unwrapped_value unwrapped() const override;
+        void accept(config_value_visitor& visitor) const override;
 
         bool operator==(config_value const& other) const override;
 
@@ -23,6 +23,9 @@ namespace hocon {
 
         std::shared_ptr<substitution_expression> expression() const;
 
+        /** The number of elements of the expression's path that were added by relativizing it. */
+        int prefix_length() const { return _prefix_length; }
+
         bool operator==(config_value const& other) const override;
 
     protected:
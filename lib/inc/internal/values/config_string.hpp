@@ -3,30 +3,107 @@
 #include <hocon/config_value.hpp>
 #include <internal/config_util.hpp>
 
+#include <atomic>
+
 namespace hocon {
 
     enum class config_string_type { QUOTED, UNQUOTED };
 
     class config_string : public config_value {
     public:
-        config_string(shared_origin origin, std::string text, config_string_type quoted);
+        /**
+         * Strings made without memoize coerce every time they're read, so
+         * reading them never writes to them; frozen configs rely on that.
+         */
+        config_string(shared_origin origin, std::string text, config_string_type quoted, bool memoize = true);
 
         config_value::type value_type() const override;
         std::string transform_to_string() const override;
 
         unwrapped_value unwrapped() const override;
+        void accept(config_value_visitor& visitor) const override;
 
         bool was_quoted() const;
         bool operator==(config_value const& other) const override;
 
+        /**
+         * Returns the coercion of this string to a number, boolean or null that
+         * an earlier call kept, or calls coerce and keeps its result unless it
+         * is this string itself, meaning the coercion failed. Other types are
+         * coerced every time. Repeated reads of the same type neither parse nor
+         * allocate; concurrent first reads may each coerce, and the first
+         * result stored wins.
+         */
+        template <typename F>
+        shared_value memoized_coercion(config_value::type requested, F coerce) const {
+            auto memo = _memoize ? coercion_memo(requested) : nullptr;
+            if (!memo) {
+                return coerce();
+            }
+            if (auto cached = memo->get()) {
+                return *cached;
+            }
+            shared_value coerced = coerce();
+            if (coerced.get() == this) {
+                return coerced;
+            }
+            return memo->set(std::move(coerced));
+        }
+
+        /** Like memoized_coercion, for the string parsed as a duration. */
+        template <typename F>
+        duration memoized_duration(F parse) const {
+            if (!_memoize) {
+                return parse();
+            }
+            if (auto cached = _duration.get()) {
+                return *cached;
+            }
+            return _duration.set(parse());
+        }
+
     protected:
         shared_value new_copy(shared_origin) const override;
 
         void render(std::string& s, int indent, bool at_root, config_render_options options) const override;
 
     private:
+        /** A value that's set at most once, published without locking. */
+        template <typename T>
+        class memo {
+        public:
+            memo() : _value(nullptr) { }
+            memo(memo const&) = delete;
+            memo& operator=(memo const&) = delete;
+            ~memo() { delete _value.load(std::memory_order_relaxed); }
+
+            T const* get() const { return _value.load(std::memory_order_acquire); }
+
+            /** Stores value unless another thread got there first; returns what's stored. */
+            T const& set(T value) const {
+                T* created = new T(std::move(value));
+                T* expected = nullptr;
+                if (!_value.compare_exchange_strong(expected, created, std::memory_order_acq_rel,
+                                                    std::memory_order_acquire)) {
+                    delete created;
+                    return *expected;
+                }
+                return *created;
+            }
+
+        private:
+            mutable std::atomic<T*> _value;
+        };
+
+        memo<shared_value> const* coercion_memo(config_value::type requested) const;
+
         std::string _text;
         config_string_type _quoted;
+        bool _memoize;
+        memo<shared_value> _number;
+        memo<shared_value> _boolean;
+        memo<shared_value> _null;
+        memo<duration> _duration;
     };
 
 }  // namespace hocon
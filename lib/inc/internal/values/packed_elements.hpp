@@ -0,0 +1,152 @@
+#pragma once
+
+#include <hocon/config_value.hpp>
+#include <internal/simple_config_origin.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hocon {
+
+    /**
+     * One column of scalar values stored unboxed: numbers as a contiguous array,
+     * booleans as bits, strings by value. Values are only packed if boxing them
+     * again gives back an equal value of the same type with an equal origin, so a
+     * packed column can stand in for the vector of values it was built from.
+     */
+    class packed_column {
+    public:
+        enum class kind { LONG, DOUBLE, BOOLEAN, STRING, CONFIG_NULL, BOXED };
+
+        /**
+         * Packs values. Origins are rebuilt from origin_template with the line
+         * number of each value, so every value's origin must look like that;
+         * default_lines gives the line each value is expected on. If the values
+         * aren't all of one packable kind the column keeps them boxed.
+         */
+        static std::unique_ptr<packed_column> pack(std::vector<shared_value> const& values,
+                                                   shared_origin const& origin_template,
+                                                   std::vector<int> const& default_lines);
+
+        kind get_kind() const { return _kind; }
+        size_t size() const { return _size; }
+
+        /** Creates the value at index; default_origin is used if its line was not stored. */
+        shared_value box(size_t index, shared_origin const& origin_template, shared_origin const& default_origin) const;
+
+        std::vector<int64_t> const& longs() const { return _longs; }
+        std::vector<double> const& doubles() const { return _doubles; }
+        bool boolean_at(size_t index) const { return (_bits[index / 64] >> (index % 64)) & 1; }
+
+        size_t memory_usage() const;
+
+        /** A hash of the values in the column, ignoring their text and lines. */
+        size_t hash() const;
+
+        /** True if a double in a DOUBLE column is boxed as a long. */
+        static bool is_whole(double value);
+
+        /** The text a number is rendered with when it wasn't given any. */
+        static std::string canonical_text(int64_t value);
+        static std::string canonical_text(double value);
+
+    private:
+        packed_column(kind k, size_t size) : _kind(k), _size(size) {}
+
+        static kind kind_of(shared_value const& v);
+
+        kind _kind;
+        size_t _size;
+        std::vector<int64_t> _longs;
+        std::vector<double> _doubles;
+        std::vector<uint64_t> _bits;
+        std::vector<std::string> _strings;
+        std::vector<shared_value> _boxed;
+        // original text of numbers that wasn't what canonical_text would give
+        std::unordered_map<size_t, std::string> _texts;
+        // line number of each value; empty if they were all on their default line
+        std::vector<int> _lines;
+    };
+
+    /**
+     * Compact storage for the elements of a resolved simple_config_list.
+     * Elements are created on access.
+     */
+    class packed_elements {
+    public:
+        virtual ~packed_elements() = default;
+
+        virtual size_t size() const = 0;
+        virtual shared_value get(size_t index) const = 0;
+
+        /** Approximate number of bytes used by the packed storage. */
+        virtual size_t memory_usage() const = 0;
+
+        /**
+         * A hash of the elements' values, ignoring origins, for telling packed
+         * lists apart without making their elements. Equal lists packed the
+         * same way have the same hash.
+         */
+        virtual size_t hash() const = 0;
+    };
+
+    /**
+     * A list of numbers or of booleans stored as a single packed_column. Values
+     * on the list's own line don't store a line number.
+     */
+    class packed_scalars : public packed_elements {
+    public:
+        /** Packs values, or returns null if they aren't all numbers or all booleans. */
+        static std::shared_ptr<const packed_scalars> pack(shared_origin const& list_origin,
+                                                          std::vector<shared_value> const& values);
+
+        size_t size() const override { return _column->size(); }
+        shared_value get(size_t index) const override;
+        size_t memory_usage() const override;
+        size_t hash() const override;
+
+        packed_column const& column() const { return *_column; }
+
+    private:
+        packed_scalars(shared_origin origin_template, std::unique_ptr<packed_column> column) :
+            _origin_template(std::move(origin_template)), _column(std::move(column)) {}
+
+        shared_origin _origin_template;
+        std::unique_ptr<packed_column> _column;
+    };
+
+    /**
+     * Columnar storage for a list of objects that all have the same keys, like
+     * [{ id : 1, weight : 0.5 }, { id : 2, weight : 0.25 }]: the keys are stored
+     * once and each key's values form a packed_column. Objects are rebuilt as
+     * simple_config_objects on access.
+     */
+    class packed_objects : public packed_elements {
+    public:
+        /**
+         * Packs values, or returns null if they aren't all resolved objects with
+         * the same keys.
+         */
+        static std::shared_ptr<const packed_objects> pack(shared_origin const& list_origin,
+                                                          std::vector<shared_value> const& values);
+
+        size_t size() const override { return _lines.size(); }
+        shared_value get(size_t index) const override;
+        size_t memory_usage() const override;
+        size_t hash() const override;
+
+        std::vector<std::string> const& keys() const { return _keys; }
+
+    private:
+        packed_objects(shared_origin origin_template) : _origin_template(std::move(origin_template)) {}
+
+        shared_origin _origin_template;
+        std::vector<std::string> _keys;
+        std::vector<std::unique_ptr<packed_column>> _columns;
+        std::vector<int> _lines;
+    };
+
+}  // namespace hocon
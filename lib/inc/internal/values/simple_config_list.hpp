@@ -5,6 +5,7 @@
 #include <hocon/config_render_options.hpp>
 #include <hocon/config_exception.hpp>
 #include <internal/container.hpp>
+#include <internal/values/packed_elements.hpp>
 #include <algorithm>
 #include <memory>
 #include <vector>
@@ -15,6 +16,20 @@ namespace hocon {
     public:
         simple_config_list(shared_origin origin, std::vector<shared_value> value);
         simple_config_list(shared_origin origin, std::vector<shared_value> value, resolve_status status);
+        simple_config_list(shared_origin origin, std::shared_ptr<const packed_elements> packed);
+
+        /**
+         * Creates a list, storing large resolved lists of similar objects, numbers
+         * or booleans in packed form when that reproduces every element exactly.
+         */
+        static std::shared_ptr<const simple_config_list> make_packed(shared_origin origin,
+                                                                     std::vector<shared_value> value);
+
+        /** Approximate number of bytes used to store the elements, not counting their children. */
+        size_t memory_usage() const;
+
+        /** The packed storage of the elements, or null if they're stored as values. */
+        std::shared_ptr<const packed_elements> const& packed() const { return _packed; }
 
         config_value::type value_type() const override { return config_value::type::LIST; }
         resolve_status get_resolve_status() const override { return _resolved; }
@@ -24,29 +39,29 @@ namespace hocon {
 
         shared_value relativized(const std::string prefix) const override;
 
-        bool contains(shared_value v) const { return std::find(_value.begin(), _value.end(), v) != _value.end(); }
+        bool contains(shared_value v) const { return index_of(move(v)) >= 0; }
         bool contains_all(std::vector<shared_value>) const;
 
-        int index_of(shared_value v) {
-            auto pos = find(_value.begin(), _value.end(), v);
-            if (pos == _value.end()) {
-                return -1;
-            } else {
-                return pos - _value.begin();
-            }
-        }
+        /**
+         * The index of v in the list, or -1. Elements of packed lists are made
+         * when they're read, so they're matched by value rather than identity.
+         */
+        int index_of(shared_value v) const;
 
         // list interface
-        bool is_empty() const override { return _value.empty(); }
-        size_t size() const override { return _value.size(); }
-        shared_value operator[](size_t index) const override { return _value.at(index); }
-        shared_value get(size_t index) const override { return _value.at(index); }
-        iterator begin() const override { return _value.begin(); }
-        iterator end() const override { return _value.end(); }
+        bool is_empty() const override { return size() == 0; }
+        size_t size() const override { return _packed ? _packed->size() : _value.size(); }
+        shared_value operator[](size_t index) const override { return get(index); }
+        shared_value get(size_t index) const override;
+        iterator begin() const override { return iterator(this, _packed ? nullptr : _value.data(), 0); }
+        iterator end() const override { return iterator(this, _packed ? nullptr : _value.data(), size()); }
+        array_view<int64_t> packed_longs() const override;
+        array_view<double> packed_doubles() const override;
 
         std::shared_ptr<const simple_config_list> concatenate(std::shared_ptr<const simple_config_list> other) const;
 
         unwrapped_value unwrapped() const override;
+        void accept(config_value_visitor& visitor) const override;
 
         bool operator==(config_value const& other) const override;
 
@@ -59,7 +74,9 @@ namespace hocon {
 
     private:
         static const long _serial_version_UID = 2L;
+        // empty for packed lists, whose elements are made each time they're read
         const std::vector<shared_value> _value;
+        const std::shared_ptr<const packed_elements> _packed;
         const resolve_status _resolved;
 
         std::shared_ptr<const simple_config_list>
@@ -4,6 +4,9 @@
 #include <hocon/config_object.hpp>
 #include <hocon/config_value.hpp>
 #include <hocon/config.hpp>
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace hocon {
@@ -15,21 +18,54 @@ namespace hocon {
 
         simple_config_object(shared_origin origin, std::unordered_map<std::string, shared_value> value);
 
+        /** Creates the entries of an object the first time they're needed. */
+        using deferred_entries = std::function<std::unordered_map<std::string, shared_value>()>;
+
+        /**
+         * Creates a resolved object whose entries are made by deferred on first
+         * use, from whichever thread uses them first.
+         */
+        simple_config_object(shared_origin origin, deferred_entries deferred);
+
+        /**
+         * Creates a resolved overlay: the entries of delta over those of base,
+         * which must be resolved and not an overlay itself. Looking up a key
+         * or asking for the size only reads delta and base. Iterating, or
+         * anything else that needs the entries as a map, copies all of base's
+         * entries into a map of the overlay's own the first time, since
+         * iterators are those of an unordered_map; after that the overlay
+         * takes as much memory as a plain copy would.
+         */
+        simple_config_object(shared_origin origin, std::shared_ptr<const simple_config_object> base,
+                             std::unordered_map<std::string, shared_value> delta, bool ignores_fallbacks);
+
+        /** True if the entries are deferred and haven't been made yet. */
+        bool is_deferred() const;
+
+        /** The object this one overlays, or null if it isn't an overlay. */
+        std::shared_ptr<const simple_config_object> const& overlay_base() const { return _base; }
+
         shared_value attempt_peek_with_partial_resolve(std::string const& key) const override;
 
         // map interface
-        bool is_empty() const override { return _value.empty(); }
-        size_t size() const override { return _value.size(); }
-        shared_value operator[](std::string const& key) const override { return _value.at(key); }
-        iterator begin() const override { return _value.begin(); }
-        iterator end() const override { return _value.end(); }
+        bool is_empty() const override { return size() == 0; }
+        size_t size() const override { return _base ? _overlay_size : entries().size(); }
+        shared_value operator[](std::string const& key) const override { return entries().at(key); }
+        iterator begin() const override { return entries().begin(); }
+        iterator end() const override { return entries().end(); }
         unwrapped_value unwrapped() const override;
+        void accept(config_value_visitor& visitor) const override;
 
         shared_value get(std::string const& key) const override {
-            if (_value.find(key) == _value.end()) {
+            if (_base) {
+                return overlay_get(key);
+            }
+            auto const& value = entries();
+            auto it = value.find(key);
+            if (it == value.end()) {
                 return nullptr;
             }
-            return _value.at(key);
+            return it->second;
         }
 
         std::unordered_map<std::string, shared_value> const& entry_set() const override;
@@ -91,7 +127,14 @@ namespace hocon {
         void render(std::string& s, int indent, bool at_root, config_render_options options) const override;
 
     private:
-        std::unordered_map<std::string, shared_value> _value;
+        // deferred objects and overlays fill _value the first time it's needed
+        mutable std::unordered_map<std::string, shared_value> _value;
+        mutable deferred_entries _deferred;
+        std::shared_ptr<const simple_config_object> _base;
+        std::unordered_map<std::string, shared_value> _delta;
+        size_t _overlay_size = 0;
+        mutable std::once_flag _made;
+        mutable std::atomic<bool> _pending { false };
         resolve_status _resolved;
         bool _ignores_fallbacks;
 
@@ -99,6 +142,10 @@ namespace hocon {
         std::shared_ptr<simple_config_object> modify(no_exceptions_modifier& modifier) const;
         std::shared_ptr<simple_config_object> modify_may_throw(modifier& modifier) const;
 
+        std::unordered_map<std::string, shared_value> const& entries() const;
+        shared_value overlay_get(std::string const& key) const;
+        shared_value overlay(std::shared_ptr<const simple_config_object> const& fallback) const;
+
         static resolve_status resolve_status_from_value(const std::unordered_map<std::string, shared_value>& value);
 
         struct resolve_modifier;
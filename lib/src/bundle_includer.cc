@@ -0,0 +1,90 @@
+#include <internal/bundle_includer.hpp>
+#include <internal/parseable.hpp>
+#include <internal/simple_includer.hpp>
+#include <internal/values/simple_config_object.hpp>
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+
+using namespace std;
+
+namespace hocon {
+
+    bundle_includer::bundle_includer(shared_ptr<const config_bundle> bundle, shared_includer fallback) :
+        _bundle(move(bundle)), _fallback(move(fallback)) { }
+
+    shared_includer bundle_includer::with_fallback(shared_includer fallback) const {
+        auto self = shared_from_this();
+        if (self == fallback) {
+            throw config_exception("Trying to create includer cycle");
+        } else if (_fallback == fallback) {
+            return self;
+        } else if (_fallback) {
+            return make_shared<bundle_includer>(_bundle, _fallback->with_fallback(move(fallback)));
+        } else {
+            return make_shared<bundle_includer>(_bundle, move(fallback));
+        }
+    }
+
+    vector<string> bundle_includer::find_in_bundle(shared_include_context const& context, string const& what) const {
+        vector<string> found;
+        if (what.empty() || what[0] == '/') {
+            return found;
+        }
+
+        string base = context->get_cur_dir() + what;
+        auto ends_with = [&](string const& ending) {
+            return what.size() >= ending.size() && what.compare(what.size() - ending.size(), ending.size(), ending) == 0;
+        };
+        vector<string> candidates;
+        if (ends_with(".conf") || ends_with(".json")) {
+            candidates.push_back(base);
+        } else {
+            // like simple_includer, .conf takes precedence over .json
+            candidates.push_back(base + ".conf");
+            candidates.push_back(base + ".json");
+        }
+        for (auto& candidate : candidates) {
+            auto path = config_bundle::normalize_path(candidate);
+            if (_bundle->contains(path)) {
+                found.push_back(move(path));
+            }
+        }
+        return found;
+    }
+
+    shared_object bundle_includer::parse_all(shared_include_context const& context, vector<string> const& paths) const {
+        shared_object obj;
+        for (auto& path : paths) {
+            auto parsed = make_shared<parseable_bundle_entry>(_bundle, path, context->parse_options())->parse();
+            obj = obj ? dynamic_pointer_cast<const config_object>(obj->with_fallback(parsed)) : parsed;
+        }
+        return obj;
+    }
+
+    shared_object bundle_includer::include(shared_include_context context, string what) const {
+        auto paths = find_in_bundle(context, what);
+        if (!paths.empty()) {
+            return parse_all(context, paths);
+        } else if (_fallback) {
+            return _fallback->include(move(context), move(what));
+        } else {
+            return simple_config_object::empty(make_shared<simple_config_origin>("empty config"));
+        }
+    }
+
+    shared_object bundle_includer::include_file(shared_include_context context, string what) const {
+        auto paths = find_in_bundle(context, what);
+        if (!paths.empty()) {
+            // resolved the same way as simple_includer::include_file
+            return parse_all(context, paths)
+                    ->to_config()
+                    ->resolve(config_resolve_options(true, true))
+                    ->root();
+        } else if (auto fallback_file = dynamic_pointer_cast<const config_includer_file>(_fallback)) {
+            return fallback_file->include_file(move(context), move(what));
+        } else {
+            return simple_includer::include_file_without_fallback(move(context), move(what));
+        }
+    }
+
+}  // namespace hocon
@@ -3,6 +3,8 @@
 #include <hocon/config_list.hpp>
 #include <hocon/config_exception.hpp>
 #include <internal/default_transformer.hpp>
+#include <internal/path_filter.hpp>
+#include <internal/config_arena.hpp>
 #include <internal/resolve_context.hpp>
 #include <internal/values/config_boolean.hpp>
 #include <internal/values/config_null.hpp>
@@ -12,10 +14,13 @@
 #include <internal/values/config_int.hpp>
 #include <internal/values/config_string.hpp>
 #include <internal/values/simple_config_object.hpp>
+#include <internal/values/simple_config_list.hpp>
 #include <internal/parseable.hpp>
 #include <internal/simple_includer.hpp>
 
 #include <cfenv>
+#include <limits>
+#include <typeinfo>
 #include <sstream>
 
 using namespace std;
@@ -108,9 +113,9 @@ namespace hocon {
         shared_value peeked;
         try {
             peeked = _object->peek_path(raw_path);
-        } catch (config_exception& ex) {
+        } catch (config_exception&) {
             if (_object->get_resolve_status() == resolve_status::RESOLVED) {
-                throw ex;
+                throw;
             }
             throw config_exception(raw_path.render() + " has not been resolved, you need to call config::resolve()");
         }
@@ -118,15 +123,39 @@ namespace hocon {
     }
 
     bool config::has_path(string const& path_expression) const {
+        if (_path_filter && _path_filter->definitely_absent(path_expression)) {
+            return false;
+        }
         shared_value peeked = has_path_peek(path_expression);
         return peeked && peeked->value_type() != config_value::type::CONFIG_NULL;
     }
 
     bool config::has_path_or_null(string const& path) const {
+        if (_path_filter && _path_filter->definitely_absent(path)) {
+            return false;
+        }
         shared_value peeked = has_path_peek(path);
         return peeked != nullptr;
     }
 
+    shared_config config::with_path_filter() const {
+        if (!is_resolved()) {
+            throw not_resolved_exception("need to config::resolve() before building a path filter");
+        }
+        auto filtered = make_shared<config>(_object);
+        filtered->_path_filter = path_filter::build(_object);
+        return filtered;
+    }
+
+    shared_config config::freeze() const {
+        if (!is_resolved()) {
+            throw not_resolved_exception("need to config::resolve() before freezing a config");
+        }
+        auto frozen = make_shared<config>(config_arena::freeze(_object));
+        frozen->_path_filter = _path_filter;
+        return frozen;
+    }
+
     bool config::is_empty() const {
         return _object->is_empty();
     }
@@ -192,20 +221,23 @@ namespace hocon {
 
     shared_value config::find_or_null(shared_object self, path desired_path,
                                              config_value::type expected, path original_path) {
+        // walk down one key at a time rather than recursing, so a failed
+        // lookup unwinds through a single handler instead of one per level
+        auto obj = self;
+        auto remaining = desired_path;
         try {
-            string key = *desired_path.first();
-            path next = desired_path.remainder();
-            if (next.empty()) {
-                return find_key_or_null(self, key, expected, original_path);
-            } else {
-                shared_object o = dynamic_pointer_cast<const config_object>(
-                        find_key(self, key, config_value::type::OBJECT,
+            path next = remaining.remainder();
+            while (!next.empty()) {
+                obj = dynamic_pointer_cast<const config_object>(
+                        find_key(obj, *remaining.first(), config_value::type::OBJECT,
                                  original_path.sub_path(0, original_path.length() - next.length())));
-                return find_or_null(o, next, expected, original_path);
+                remaining = next;
+                next = remaining.remainder();
             }
-        } catch (config_exception& ex) {
+            return find_key_or_null(obj, *remaining.first(), expected, original_path);
+        } catch (config_exception&) {
             if (self->get_resolve_status() == resolve_status::RESOLVED) {
-                throw ex;
+                throw;
             }
             throw config_exception(desired_path.render() + "has not been resolved, you need to call config::resolve()");
         }
@@ -297,6 +329,123 @@ namespace hocon {
         return object_list;
     }
 
+    template <typename T, typename Convert>
+    static vector<T> get_homogeneous_list(shared_list const& list, string const& path,
+                                          config_value::type expected, Convert convert) {
+        vector<T> result;
+        result.reserve(list->size());
+        for (auto& item : *list) {
+            if (item->value_type() != expected) {
+                throw wrong_type_exception(path + " has an element that could not be converted to the requested type");
+            }
+            result.push_back(convert(*item));
+        }
+        return result;
+    }
+
+    static vector<double> copy_packed_doubles(shared_list const& list) {
+        auto longs = list->packed_longs();
+        if (!longs.empty()) {
+            return vector<double>(longs.begin(), longs.end());
+        }
+        auto doubles = list->packed_doubles();
+        return vector<double>(doubles.begin(), doubles.end());
+    }
+
+    // int and long lists reject doubles with a fraction rather than truncate them
+    static void check_whole(double d, string const& path) {
+        if (!packed_column::is_whole(d)) {
+            throw wrong_type_exception(path + " has an element that could not be converted to the requested type");
+        }
+    }
+
+    static void check_whole(config_number const& n, string const& path) {
+        if (typeid(n) == typeid(config_double)) {
+            check_whole(n.double_value(), path);
+        }
+    }
+
+    static vector<int64_t> copy_packed_longs(shared_list const& list, string const& path) {
+        auto longs = list->packed_longs();
+        if (!longs.empty()) {
+            return vector<int64_t>(longs.begin(), longs.end());
+        }
+        vector<int64_t> result;
+        result.reserve(list->packed_doubles().size);
+        for (auto d : list->packed_doubles()) {
+            check_whole(d, path);
+            result.push_back(static_cast<int64_t>(d));
+        }
+        return result;
+    }
+
+    vector<bool> config::get_bool_list(string const& path) const {
+        auto list = get_list(path);
+        if (auto simple = dynamic_pointer_cast<const simple_config_list>(list)) {
+            auto scalars = dynamic_pointer_cast<const packed_scalars>(simple->packed());
+            if (scalars && scalars->column().get_kind() == packed_column::kind::BOOLEAN) {
+                vector<bool> result(scalars->size());
+                for (size_t i = 0; i < result.size(); ++i) {
+                    result[i] = scalars->column().boolean_at(i);
+                }
+                return result;
+            }
+        }
+        return get_homogeneous_list<bool>(list, path, config_value::type::BOOLEAN, [](config_value const& v) {
+            return dynamic_cast<config_boolean const&>(v).bool_value();
+        });
+    }
+
+    vector<int> config::get_int_list(string const& path) const {
+        auto list = get_list(path);
+        if (!list->packed_longs().empty() || !list->packed_doubles().empty()) {
+            auto longs = copy_packed_longs(list, path);
+            vector<int> result;
+            result.reserve(longs.size());
+            for (size_t i = 0; i < longs.size(); ++i) {
+                if (longs[i] < numeric_limits<int>::min() || longs[i] > numeric_limits<int>::max()) {
+                    // box the element so the error is reported the same way as for get_int
+                    dynamic_pointer_cast<const config_number>(list->get(i))->int_value_range_checked(path);
+                }
+                result.push_back(static_cast<int>(longs[i]));
+            }
+            return result;
+        }
+        return get_homogeneous_list<int>(list, path, config_value::type::NUMBER, [&](config_value const& v) {
+            auto& n = dynamic_cast<config_number const&>(v);
+            check_whole(n, path);
+            return n.int_value_range_checked(path);
+        });
+    }
+
+    vector<int64_t> config::get_long_list(string const& path) const {
+        auto list = get_list(path);
+        if (!list->packed_longs().empty() || !list->packed_doubles().empty()) {
+            return copy_packed_longs(list, path);
+        }
+        return get_homogeneous_list<int64_t>(list, path, config_value::type::NUMBER, [&](config_value const& v) {
+            auto& n = dynamic_cast<config_number const&>(v);
+            check_whole(n, path);
+            return n.long_value();
+        });
+    }
+
+    vector<double> config::get_double_list(string const& path) const {
+        auto list = get_list(path);
+        if (!list->packed_longs().empty() || !list->packed_doubles().empty()) {
+            return copy_packed_doubles(list);
+        }
+        return get_homogeneous_list<double>(list, path, config_value::type::NUMBER, [](config_value const& v) {
+            return dynamic_cast<config_number const&>(v).double_value();
+        });
+    }
+
+    vector<string> config::get_string_list(string const& path) const {
+        return get_homogeneous_list<string>(get_list(path), path, config_value::type::STRING, [](config_value const& v) {
+            return v.transform_to_string();
+        });
+    }
+
     duration config::get_duration(string const& path) const {
         auto v = get_value(path);
         if (auto d = dynamic_pointer_cast<const config_double>(v)) {
@@ -306,7 +455,7 @@ namespace hocon {
         } else if (auto i = dynamic_pointer_cast<const config_int>(v)) {
             return convert(i->long_value(), time_unit::MILLISECONDS);
         } else if (auto str = dynamic_pointer_cast<const config_string>(v)) {
-            return parse_duration(str->transform_to_string(), str->origin(), path);
+            return str->memoized_duration([&]() { return parse_duration(str->transform_to_string(), str->origin(), path); });
         } else {
             throw bad_value_exception(*v->origin(), path, "Value at '" + path + "' was not a number or string.");
         }
@@ -526,7 +675,8 @@ namespace hocon {
     }
 
     shared_includer config::default_includer() {
-        static auto _default_includer = make_shared<simple_includer>(nullptr);
+        // includers are immutable, so one instance serves every parse
+        static const shared_includer _default_includer = make_shared<simple_includer>(nullptr);
         return _default_includer;
     }
 
@@ -549,17 +699,13 @@ namespace hocon {
     }
 
     shared_object config::env_variables_as_config_object() {
-        unordered_map<string, shared_value> values;
-        throw runtime_error("Env variables as config disabled");
-        /*
-        leatherman::util::environment::each([&](string& k, string& v) {
-            auto origin = make_shared<simple_config_origin>("env var " + k);
-            values.emplace(k, make_shared<config_string>(origin, v, config_string_type::QUOTED));
-            return true;
-        });
-        */
-        auto origin = make_shared<simple_config_origin>("env variables");
-        return make_shared<simple_config_object>(origin, move(values), resolve_status::RESOLVED, false);
+        // the environment isn't read, so substitutions that miss in the config
+        // aren't found there either; this is hit on every such miss, so it
+        // hands back one shared empty object
+        static const shared_object env_object = make_shared<simple_config_object>(
+            make_shared<simple_config_origin>("env variables"), unordered_map<string, shared_value>(),
+            resolve_status::RESOLVED, false);
+        return env_object;
     }
 
 
@@ -0,0 +1,128 @@
+#include <internal/config_arena.hpp>
+#include <hocon/config_object.hpp>
+#include <internal/values/config_boolean.hpp>
+#include <internal/values/config_double.hpp>
+#include <internal/values/config_int.hpp>
+#include <internal/values/config_long.hpp>
+#include <internal/values/config_null.hpp>
+#include <internal/values/config_string.hpp>
+#include <internal/values/simple_config_list.hpp>
+#include <internal/values/simple_config_object.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+using namespace std;
+
+namespace hocon {
+
+    config_arena::config_arena(size_t block_size) :
+        _block_size(block_size), _next(nullptr), _end(nullptr), _used(0) {}
+
+    void* config_arena::allocate(size_t bytes, size_t alignment) {
+        auto aligned = [&]() {
+            auto address = reinterpret_cast<uintptr_t>(_next);
+            return reinterpret_cast<char*>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        };
+        char* start = _next ? aligned() : nullptr;
+        if (!start || start + bytes > _end) {
+            // anything bigger than a block gets a block of its own
+            size_t size = max(_block_size, bytes + alignment);
+            _blocks.emplace_back(new char[size]);
+            _next = _blocks.back().get();
+            _end = _next + size;
+            start = aligned();
+        }
+        _used += start + bytes - _next;
+        _next = start + bytes;
+        return start;
+    }
+
+    namespace {
+
+    class freezer {
+    public:
+        // the copies are kept alive in owners and handed out as pointers that don't own them
+        freezer(shared_ptr<config_arena> arena, vector<shared_ptr<const void>>& owners) :
+            _arena(move(arena)), _owners(owners) {}
+
+        shared_value copy(shared_value const& v) {
+            if (auto object = dynamic_pointer_cast<const simple_config_object>(v)) {
+                vector<string> keys;
+                keys.reserve(object->size());
+                for (auto const& entry : *object) {
+                    keys.push_back(entry.first);
+                }
+                sort(keys.begin(), keys.end());
+
+                unordered_map<string, shared_value> entries;
+                entries.reserve(keys.size());
+                for (auto& key : keys) {
+                    auto child = copy(object->get(key));
+                    entries.emplace(move(key), move(child));
+                }
+                return make<simple_config_object>(v->origin(), move(entries), resolve_status::RESOLVED,
+                                                  object->ignores_fallbacks());
+            }
+            if (auto list = dynamic_pointer_cast<const simple_config_list>(v)) {
+                // reading a packed list makes its elements, counting references to
+                // their origins, which would write to a frozen one, so lists are unpacked
+                vector<shared_value> elements;
+                elements.reserve(list->size());
+                for (size_t i = 0; i < list->size(); ++i) {
+                    elements.push_back(copy(list->get(i)));
+                }
+                return make<simple_config_list>(v->origin(), move(elements), resolve_status::RESOLVED);
+            }
+            if (auto s = dynamic_pointer_cast<const config_string>(v)) {
+                return make<config_string>(v->origin(), s->transform_to_string(),
+                                           s->was_quoted() ? config_string_type::QUOTED : config_string_type::UNQUOTED,
+                                           false);
+            }
+            if (auto i = dynamic_pointer_cast<const config_int>(v)) {
+                return make<config_int>(v->origin(), static_cast<int>(i->long_value()), i->transform_to_string());
+            }
+            if (auto l = dynamic_pointer_cast<const config_long>(v)) {
+                return make<config_long>(v->origin(), l->long_value(), l->transform_to_string());
+            }
+            if (auto d = dynamic_pointer_cast<const config_double>(v)) {
+                return make<config_double>(v->origin(), d->double_value(), d->transform_to_string());
+            }
+            if (auto b = dynamic_pointer_cast<const config_boolean>(v)) {
+                return make<config_boolean>(v->origin(), b->bool_value());
+            }
+            if (dynamic_pointer_cast<const config_null>(v)) {
+                return make<config_null>(v->origin());
+            }
+            return pin(v);
+        }
+
+    private:
+        template <typename T, typename... Args>
+        shared_ptr<const T> make(Args&&... args) {
+            return pin(shared_ptr<const T>(allocate_shared<T>(arena_allocator<T>(_arena), forward<Args>(args)...)));
+        }
+
+        template <typename T>
+        shared_ptr<T> pin(shared_ptr<T> owner) {
+            if (!owner) {
+                return owner;
+            }
+            _owners.push_back(owner);
+            return shared_ptr<T>(shared_ptr<T>(), owner.get());
+        }
+
+        shared_ptr<config_arena> _arena;
+        vector<shared_ptr<const void>>& _owners;
+    };
+
+    }  // anonymous namespace
+
+    shared_object config_arena::freeze(shared_object const& root) {
+        // deliberately leaked, so the frozen values are never destroyed
+        auto owners = new vector<shared_ptr<const void>>();
+        return dynamic_pointer_cast<const config_object>(freezer(make_shared<config_arena>(), *owners).copy(root));
+    }
+
+}  // namespace hocon
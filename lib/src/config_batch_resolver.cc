@@ -0,0 +1,286 @@
+#include <hocon/config_batch_resolver.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/config_list.hpp>
+#include <hocon/config_object.hpp>
+#include <internal/substitution_expression.hpp>
+#include <internal/unmergeable.hpp>
+#include <internal/values/config_concatenation.hpp>
+#include <internal/values/config_reference.hpp>
+#include <internal/values/config_string.hpp>
+#include <internal/values/simple_config_object.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+
+using namespace std;
+
+namespace hocon {
+
+    // rough size of a value and its control block, not counting strings, as config_resolve_cache counts it
+    static const size_t value_overhead = 96;
+
+    static vector<string> keys_of(path p) {
+        vector<string> keys;
+        for (; !p.empty(); p = p.remainder()) {
+            keys.push_back(*p.first());
+        }
+        return keys;
+    }
+
+    // renderings of each prefix of a path, shortest first
+    static vector<string> prefixes_of(vector<string> const& keys) {
+        vector<string> prefixes;
+        for (size_t n = 1; n <= keys.size(); ++n) {
+            prefixes.push_back(path(vector<string>(keys.begin(), keys.begin() + n)).render());
+        }
+        return prefixes;
+    }
+
+    // true if one path is the other or inside it
+    static bool overlapping(vector<string> const& a, vector<string> const& b) {
+        size_t n = min(a.size(), b.size());
+        return equal(a.begin(), a.begin() + n, b.begin());
+    }
+
+    static void find_references(shared_value const& v, vector<vector<string>>& paths) {
+        if (v->get_resolve_status() == resolve_status::RESOLVED) {
+            return;
+        }
+        if (auto reference = dynamic_pointer_cast<const config_reference>(v)) {
+            paths.push_back(keys_of(reference->expression()->get_path()));
+        } else if (auto concatenation = dynamic_pointer_cast<const config_concatenation>(v)) {
+            for (auto const& piece : concatenation->pieces()) {
+                find_references(piece, paths);
+            }
+        } else if (auto unmerged = dynamic_pointer_cast<const unmergeable>(v)) {
+            for (auto const& part : unmerged->unmerged_values()) {
+                find_references(part, paths);
+            }
+        } else if (auto object = dynamic_pointer_cast<const simple_config_object>(v)) {
+            for (auto const& entry : *object) {
+                find_references(entry.second, paths);
+            }
+        } else if (auto list = dynamic_pointer_cast<const config_list>(v)) {
+            for (auto const& element : *list) {
+                find_references(element, paths);
+            }
+        }
+    }
+
+    static size_t record_memory(shared_value const& v, unordered_map<config_value const*, size_t>& memory) {
+        auto found = memory.find(v.get());
+        if (found != memory.end()) {
+            return found->second;
+        }
+        size_t bytes = value_overhead;
+        if (auto object = dynamic_pointer_cast<const simple_config_object>(v)) {
+            for (auto const& entry : *object) {
+                bytes += entry.first.size() + sizeof(entry) + record_memory(entry.second, memory);
+            }
+        } else if (auto list = dynamic_pointer_cast<const config_list>(v)) {
+            for (auto const& element : *list) {
+                bytes += record_memory(element, memory);
+            }
+        } else if (dynamic_pointer_cast<const config_string>(v)) {
+            bytes += v->transform_to_string().size();
+        }
+        memory.emplace(v.get(), bytes);
+        return bytes;
+    }
+
+    config_batch_resolver::config_batch_resolver(shared_config base, config_resolve_options options) :
+        _options(options), _resolved(base->resolve(options.set_allow_unresolved(true)))
+    {
+        // the values with substitutions, splitting objects that only have some into their children
+        vector<string> keys;
+        function<void(shared_object const&, shared_object const&)> collect =
+            [&](shared_object const& raw, shared_object const& resolved) {
+                for (auto const& entry : *raw) {
+                    if (entry.second->get_resolve_status() == resolve_status::RESOLVED) {
+                        continue;
+                    }
+                    keys.push_back(entry.first);
+                    auto resolved_value = resolved->get(entry.first);
+                    auto raw_object = dynamic_pointer_cast<const simple_config_object>(entry.second);
+                    auto resolved_object = dynamic_pointer_cast<const simple_config_object>(resolved_value);
+                    if (raw_object && resolved_object) {
+                        collect(raw_object, resolved_object);
+                    } else {
+                        _substituted.push_back(substituted { keys, entry.second, resolved_value, {} });
+                    }
+                    keys.pop_back();
+                }
+            };
+        collect(base->root(), _resolved->root());
+
+        // a value reads the paths of its substitutions, and whatever the values at those paths read
+        vector<vector<vector<string>>> references(_substituted.size());
+        for (size_t i = 0; i < _substituted.size(); ++i) {
+            find_references(_substituted[i].raw, references[i]);
+        }
+        for (size_t i = 0; i < _substituted.size(); ++i) {
+            vector<vector<string>> reads;
+            vector<bool> visited(_substituted.size());
+            vector<size_t> pending { i };
+            visited[i] = true;
+            while (!pending.empty()) {
+                auto j = pending.back();
+                pending.pop_back();
+                for (auto const& read : references[j]) {
+                    reads.push_back(read);
+                    for (size_t k = 0; k < _substituted.size(); ++k) {
+                        if (!visited[k] && overlapping(read, _substituted[k].keys)) {
+                            visited[k] = true;
+                            pending.push_back(k);
+                        }
+                    }
+                }
+            }
+            sort(reads.begin(), reads.end());
+            reads.erase(unique(reads.begin(), reads.end()), reads.end());
+            for (auto const& read : reads) {
+                _substituted[i].reads.push_back(prefixes_of(read));
+            }
+        }
+
+        record_memory(_resolved->root(), _base_memory);
+    }
+
+    size_t config_batch_resolver::measure(shared_value const& v, size_t& shared_memory) const {
+        auto found = _base_memory.find(v.get());
+        if (found != _base_memory.end()) {
+            shared_memory += found->second;
+            return found->second;
+        }
+        size_t bytes = value_overhead;
+        if (auto object = dynamic_pointer_cast<const simple_config_object>(v)) {
+            for (auto const& entry : *object) {
+                bytes += entry.first.size() + sizeof(entry) + measure(entry.second, shared_memory);
+            }
+        } else if (auto list = dynamic_pointer_cast<const config_list>(v)) {
+            for (auto const& element : *list) {
+                bytes += measure(element, shared_memory);
+            }
+        } else if (dynamic_pointer_cast<const config_string>(v)) {
+            bytes += v->transform_to_string().size();
+        }
+        return bytes;
+    }
+
+    config_batch_resolver::result config_batch_resolver::resolve(shared_config const& overlay) const {
+        // the paths of the overlay's values, and every path above one; an empty
+        // object still replaces a value that isn't an object
+        unordered_set<string> leaves, touched;
+        vector<string> keys;
+        function<void(shared_object const&)> walk = [&](shared_object const& object) {
+            for (auto const& entry : *object) {
+                keys.push_back(entry.first);
+                auto child = dynamic_pointer_cast<const simple_config_object>(entry.second);
+                auto prefixes = prefixes_of(keys);
+                touched.insert(prefixes.begin(), prefixes.end());
+                if (!child) {
+                    leaves.insert(prefixes.back());
+                } else {
+                    walk(child);
+                }
+                keys.pop_back();
+            }
+        };
+        walk(overlay->root());
+
+        auto affected = [&](substituted const& s) {
+            if (!s.resolved || s.resolved->get_resolve_status() != resolve_status::RESOLVED) {
+                return true;
+            }
+            for (auto const& read : s.reads) {
+                if (touched.count(read.back())) {
+                    return true;
+                }
+                for (auto const& prefix : read) {
+                    if (leaves.count(prefix)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        // put the affected values back as they were parsed, copying only the objects above them
+        function<shared_object(shared_object const&, vector<substituted const*> const&, size_t)> restore =
+            [&](shared_object const& object, vector<substituted const*> const& values, size_t depth) -> shared_object {
+                unordered_map<string, shared_value> entries(object->begin(), object->end());
+                unordered_map<string, vector<substituted const*>> below;
+                for (auto value : values) {
+                    auto const& key = value->keys[depth];
+                    if (value->keys.size() == depth + 1) {
+                        entries[key] = value->raw;
+                    } else {
+                        below[key].push_back(value);
+                    }
+                }
+                for (auto const& group : below) {
+                    auto child = dynamic_pointer_cast<const config_object>(object->get(group.first));
+                    if (!child) {
+                        throw bug_or_broken_exception("resolved base lost an object above a substitution");
+                    }
+                    entries[group.first] = restore(child, group.second, depth + 1);
+                }
+                return make_shared<simple_config_object>(object->origin(), move(entries));
+            };
+
+        vector<substituted const*> restored;
+        for (auto const& s : _substituted) {
+            if (affected(s)) {
+                restored.push_back(&s);
+            }
+        }
+        auto fallback = restored.empty() ? _resolved->root() : restore(_resolved->root(), restored, 0);
+        auto merged = dynamic_pointer_cast<const config>(overlay->with_fallback(fallback));
+
+        result r;
+        r.config = merged->resolve(_options);
+        r.shared_memory = 0;
+        r.memory_usage = measure(r.config->root(), r.shared_memory);
+        return r;
+    }
+
+    vector<config_batch_resolver::result>
+    config_batch_resolver::resolve_all(vector<shared_config> const& overlays, unsigned threads) const {
+        if (threads == 0) {
+            threads = max(1u, thread::hardware_concurrency());
+        }
+        vector<result> results(overlays.size());
+        vector<exception_ptr> errors(overlays.size());
+
+        atomic<size_t> next { 0 };
+        auto run = [&]() {
+            for (size_t i; (i = next++) < overlays.size();) {
+                try {
+                    results[i] = resolve(overlays[i]);
+                } catch (...) {
+                    errors[i] = current_exception();
+                }
+            }
+        };
+        vector<thread> workers;
+        for (size_t t = 1; t < min<size_t>(threads, overlays.size()); ++t) {
+            workers.emplace_back(run);
+        }
+        run();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (auto const& error : errors) {
+            if (error) {
+                rethrow_exception(error);
+            }
+        }
+        return results;
+    }
+
+}  // namespace hocon
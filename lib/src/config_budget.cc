@@ -0,0 +1,72 @@
+#include <hocon/config_budget.hpp>
+#include <hocon/config_exception.hpp>
+
+using namespace std;
+
+namespace hocon {
+
+    // how often the counters that go up one at a time look at the clock
+    static const size_t deadline_interval = 256;
+
+    config_budget::config_budget(config_limits limits) :
+        _limits(limits), _deadline(chrono::steady_clock::now() + limits.time_limit),
+        _bytes(0), _tokens(0), _includes(0), _expansions(0), _output(0) {}
+
+    void config_budget::exceeded(size_t limit, string const& what) {
+        throw budget_exceeded_exception("config exceeded its limit of " + to_string(limit) + " " + what);
+    }
+
+    void config_budget::spend_bytes(size_t bytes) {
+        if ((_bytes += bytes) > _limits.max_bytes && _limits.max_bytes) {
+            exceeded(_limits.max_bytes, "bytes");
+        }
+        check_deadline();
+    }
+
+    void config_budget::spend_token() {
+        auto tokens = ++_tokens;
+        if (tokens > _limits.max_tokens && _limits.max_tokens) {
+            exceeded(_limits.max_tokens, "tokens");
+        }
+        if (tokens % deadline_interval == 0) {
+            check_deadline();
+        }
+    }
+
+    void config_budget::check_depth(size_t depth) const {
+        if (depth > _limits.max_depth && _limits.max_depth) {
+            exceeded(_limits.max_depth, "levels of nesting");
+        }
+    }
+
+    void config_budget::spend_include() {
+        if (++_includes > _limits.max_includes && _limits.max_includes) {
+            exceeded(_limits.max_includes, "includes");
+        }
+        check_deadline();
+    }
+
+    void config_budget::spend_expansion() {
+        auto expansions = ++_expansions;
+        if (expansions > _limits.max_expansions && _limits.max_expansions) {
+            exceeded(_limits.max_expansions, "substitution expansions");
+        }
+        if (expansions % deadline_interval == 0) {
+            check_deadline();
+        }
+    }
+
+    void config_budget::spend_output(size_t amount) {
+        if ((_output += amount) > _limits.max_output && _limits.max_output) {
+            exceeded(_limits.max_output, "bytes or elements of concatenated output");
+        }
+    }
+
+    void config_budget::check_deadline() const {
+        if (_limits.time_limit.count() > 0 && chrono::steady_clock::now() > _deadline) {
+            throw budget_exceeded_exception("config exceeded its time limit of " +
+                                            to_string(_limits.time_limit.count()) + "ms");
+        }
+    }
+
+}  // namespace hocon
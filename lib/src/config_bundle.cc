@@ -0,0 +1,270 @@
+#include <hocon/config_bundle.hpp>
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+#include <internal/bundle_includer.hpp>
+#include <internal/parseable.hpp>
+#include <internal/simple_config_origin.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace hocon {
+
+    static const char bundle_magic[8] = { 'H', 'O', 'C', 'O', 'N', 'B', 'D', 'L' };
+    static const uint32_t bundle_version = 1;
+    static const size_t header_size = 16;
+    static const size_t index_entry_size = 32;
+
+    static uint64_t read_le(char const* p, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    static void write_le(string& out, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    static int compare(array_view<char> a, array_view<char> b) {
+        int c = memcmp(a.data, b.data, min(a.size, b.size));
+        if (c != 0) {
+            return c;
+        }
+        return a.size < b.size ? -1 : (a.size > b.size ? 1 : 0);
+    }
+
+    static int compare(array_view<char> a, string const& b) {
+        return compare(a, array_view<char> { b.data(), b.size() });
+    }
+
+    string config_bundle::normalize_path(string const& path) {
+        vector<string> elements;
+        size_t start = 0;
+        while (start <= path.size()) {
+            size_t end = path.find('/', start);
+            if (end == string::npos) {
+                end = path.size();
+            }
+            string element = path.substr(start, end - start);
+            if (element == "..") {
+                if (!elements.empty() && elements.back() != "..") {
+                    elements.pop_back();
+                } else {
+                    elements.push_back(element);
+                }
+            } else if (!element.empty() && element != ".") {
+                elements.push_back(move(element));
+            }
+            start = end + 1;
+        }
+
+        string result;
+        for (auto& element : elements) {
+            if (!result.empty()) {
+                result += '/';
+            }
+            result += element;
+        }
+        return result;
+    }
+
+    config_bundle::config_bundle(string path) :
+        _path(move(path)), _data(nullptr), _size(0), _count(0) { }
+
+    config_bundle::~config_bundle() {
+#ifndef _WIN32
+        if (_data && _contents.empty()) {
+            munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+    }
+
+    shared_ptr<const config_bundle> config_bundle::open(string const& bundle_path) {
+        shared_ptr<config_bundle> bundle(new config_bundle(bundle_path));
+        bundle->map();
+        bundle->read_index();
+        return bundle;
+    }
+
+    void config_bundle::map() {
+        simple_config_origin origin("bundle " + _path);
+#ifndef _WIN32
+        int fd = ::open(_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw io_exception(origin, "could not open bundle: " + string(strerror(errno)));
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw io_exception(origin, "could not read bundle: " + string(strerror(errno)));
+        }
+        _size = static_cast<size_t>(info.st_size);
+        if (_size > 0) {
+            void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw io_exception(origin, "could not map bundle: " + string(strerror(errno)));
+            }
+            _data = static_cast<char const*>(mapped);
+        }
+        ::close(fd);
+#else
+        ifstream in(_path, ios::binary);
+        if (!in) {
+            throw io_exception(origin, "could not open bundle");
+        }
+        _contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        _data = _contents.data();
+        _size = _contents.size();
+#endif
+    }
+
+    void config_bundle::read_index() {
+        simple_config_origin origin("bundle " + _path);
+        if (_size < header_size || memcmp(_data, bundle_magic, sizeof(bundle_magic)) != 0) {
+            throw io_exception(origin, "not a config bundle");
+        }
+        if (read_le(_data + 8, 4) != bundle_version) {
+            throw io_exception(origin, "unsupported config bundle version " + to_string(read_le(_data + 8, 4)));
+        }
+        _count = static_cast<uint32_t>(read_le(_data + 12, 4));
+        if ((_size - header_size) / index_entry_size < _count) {
+            throw io_exception(origin, "config bundle index is truncated");
+        }
+
+        // check every offset once here so lookups don't have to
+        for (uint32_t i = 0; i < _count; ++i) {
+            char const* p = _data + header_size + i * index_entry_size;
+            uint64_t path_offset = read_le(p, 8), path_size = read_le(p + 8, 4);
+            uint64_t source_offset = read_le(p + 16, 8), source_size = read_le(p + 24, 8);
+            if (path_offset > _size || path_size > _size - path_offset ||
+                    source_offset > _size || source_size > _size - source_offset) {
+                throw io_exception(origin, "config bundle entry " + to_string(i) + " is out of bounds");
+            }
+            // lookups binary search the index
+            if (i > 0 && compare(entry_at(i - 1).path, entry_at(i).path) >= 0) {
+                throw io_exception(origin, "config bundle index is not sorted by path at entry " + to_string(i));
+            }
+        }
+    }
+
+    config_bundle::entry config_bundle::entry_at(uint32_t index) const {
+        char const* p = _data + header_size + index * index_entry_size;
+        entry e;
+        e.path.data = _data + read_le(p, 8);
+        e.path.size = static_cast<size_t>(read_le(p + 8, 4));
+        e.source.data = _data + read_le(p + 16, 8);
+        e.source.size = static_cast<size_t>(read_le(p + 24, 8));
+        return e;
+    }
+
+    int64_t config_bundle::find(string const& normalized_path) const {
+        uint32_t low = 0, high = _count;
+        while (low < high) {
+            uint32_t mid = low + (high - low) / 2;
+            int c = compare(entry_at(mid).path, normalized_path);
+            if (c == 0) {
+                return mid;
+            } else if (c < 0) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return -1;
+    }
+
+    vector<string> config_bundle::paths() const {
+        vector<string> result;
+        result.reserve(_count);
+        for (uint32_t i = 0; i < _count; ++i) {
+            auto path = entry_at(i).path;
+            result.emplace_back(path.begin(), path.end());
+        }
+        return result;
+    }
+
+    bool config_bundle::contains(string const& path) const {
+        return find(normalize_path(path)) >= 0;
+    }
+
+    array_view<char> config_bundle::source(string const& path) const {
+        auto index = find(normalize_path(path));
+        if (index < 0) {
+            return {};
+        }
+        return entry_at(static_cast<uint32_t>(index)).source;
+    }
+
+    shared_config config_bundle::parse_file(string const& path, config_parse_options options) const {
+        auto normalized = normalize_path(path);
+        if (find(normalized) < 0) {
+            throw io_exception(simple_config_origin("bundle " + _path), "no file '" + path + "' in bundle");
+        }
+        options = options.prepend_includer(make_shared<bundle_includer>(shared_from_this(), nullptr));
+        return make_shared<parseable_bundle_entry>(shared_from_this(), move(normalized), move(options))
+                ->parse()
+                ->to_config();
+    }
+
+    void config_bundle::write(string const& bundle_path, string const& root_dir, vector<string> const& files) {
+        simple_config_origin origin("bundle " + bundle_path);
+
+        vector<pair<string, string>> entries;
+        for (auto& file : files) {
+            string name = normalize_path(file);
+            string full_path = root_dir.empty() ? name : root_dir + "/" + name;
+            ifstream in(full_path, ios::binary);
+            if (!in) {
+                throw io_exception(origin, "could not read " + full_path);
+            }
+            entries.emplace_back(move(name), string(istreambuf_iterator<char>(in), istreambuf_iterator<char>()));
+        }
+        sort(entries.begin(), entries.end());
+        entries.erase(unique(entries.begin(), entries.end(), [](pair<string, string> const& a, pair<string, string> const& b) {
+            return a.first == b.first;
+        }), entries.end());
+
+        string out(bundle_magic, sizeof(bundle_magic));
+        write_le(out, bundle_version, 4);
+        write_le(out, entries.size(), 4);
+
+        uint64_t offset = header_size + entries.size() * index_entry_size;
+        for (auto& e : entries) {
+            write_le(out, offset, 8);
+            write_le(out, e.first.size(), 4);
+            write_le(out, 0, 4);
+            offset += e.first.size();
+            write_le(out, offset, 8);
+            write_le(out, e.second.size(), 8);
+            offset += e.second.size();
+        }
+        for (auto& e : entries) {
+            out += e.first;
+            out += e.second;
+        }
+
+        ofstream file(bundle_path, ios::binary | ios::trunc);
+        file.write(out.data(), out.size());
+        if (!file) {
+            throw io_exception(origin, "could not write bundle");
+        }
+    }
+
+}  // namespace hocon
@@ -1,4 +1,5 @@
 #include <internal/config_document_parser.hpp>
+#include <hocon/config_budget.hpp>
 #include <internal/nodes/config_node_single_token.hpp>
 #include <internal/nodes/config_node_comment.hpp>
 #include <internal/nodes/config_node_concatenation.hpp>
@@ -17,21 +18,22 @@ namespace hocon { namespace config_document_parser {
     shared_ptr<config_node_root> parse(token_iterator tokens, shared_origin origin,
                                                                     config_parse_options options)
     {
-        parse_context context { options.get_syntax(), move(origin), move(tokens) };
+        parse_context context { options.get_syntax(), move(origin), move(tokens), options.get_budget() };
         return context.parse();
     }
 
     shared_node_value parse_value(token_iterator tokens, shared_origin origin,
                                                           config_parse_options options)
     {
-        parse_context context { options.get_syntax(), move(origin), move(tokens) };
+        parse_context context { options.get_syntax(), move(origin), move(tokens), options.get_budget() };
         return context.parse_single_value();
     }
 
     /** Parse context */
-    parse_context::parse_context(config_syntax flavor, shared_origin origin, token_iterator tokens) :
+    parse_context::parse_context(config_syntax flavor, shared_origin origin, token_iterator tokens,
+                                 shared_budget budget) :
         _line_number(1), _tokens(move(tokens)), _flavor(flavor), _base_origin(move(origin)),
-        _equals_count(0) { }
+        _equals_count(0), _budget(move(budget)), _depth(0) { }
 
     parse_exception parse_context::parse_error(string message) {
         return parse_exception(*_base_origin->with_line_number(_line_number), move(message));
@@ -39,6 +41,9 @@ namespace hocon { namespace config_document_parser {
 
     shared_token parse_context::pop_token() {
         if (_buffer.empty()) {
+            if (_budget) {
+                _budget->spend_token();
+            }
             return _tokens.next();
         }
         shared_token top = _buffer.top();
@@ -222,10 +227,13 @@ namespace hocon { namespace config_document_parser {
         if (t->get_token_type() == token_type::VALUE || t->get_token_type() == token_type::UNQUOTED_TEXT ||
                 t->get_token_type() == token_type::SUBSTITUTION) {
             v = make_shared<config_node_simple_value>(t);
-        } else if (t->get_token_type() == token_type::OPEN_CURLY) {
-            v = parse_object(true);
-        } else if (t->get_token_type() == token_type::OPEN_SQUARE) {
-            v = parse_array();
+        } else if (t->get_token_type() == token_type::OPEN_CURLY || t->get_token_type() == token_type::OPEN_SQUARE) {
+            if (_budget) {
+                _budget->check_depth(_depth + 1);
+            }
+            ++_depth;
+            v = t->get_token_type() == token_type::OPEN_CURLY ? parse_object(true) : parse_array();
+            --_depth;
         } else {
             throw parse_error(add_quote_suggestion(t->to_string(),
                                                    "Expecting a value but got wrong token: " + t->to_string()));
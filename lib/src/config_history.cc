@@ -0,0 +1,231 @@
+#include <hocon/config_history.hpp>
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/path.hpp>
+#include <internal/values/simple_config_object.hpp>
+#include <internal/values/simple_config_list.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <typeinfo>
+
+using namespace std;
+
+namespace hocon {
+
+    static size_t mix(size_t h) {
+        uint64_t x = h;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+
+    static size_t hash_combine(size_t seed, size_t h) {
+        return seed ^ (mix(h) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    static bool is_packed(shared_value const& v) {
+        auto list = dynamic_pointer_cast<const simple_config_list>(v);
+        return list && list->packed();
+    }
+
+    // True if a and b have the same content, given that their children are stored values.
+    static bool same_content(shared_value const& a, shared_value const& b) {
+        if (a->value_type() != b->value_type()) {
+            return false;
+        }
+        if (a->value_type() == config_value::type::OBJECT) {
+            auto a_obj = dynamic_pointer_cast<const config_object>(a);
+            auto b_obj = dynamic_pointer_cast<const config_object>(b);
+            if (a_obj->size() != b_obj->size()) {
+                return false;
+            }
+            return all_of(a_obj->begin(), a_obj->end(), [&](pair<string const, shared_value> const& entry) {
+                return b_obj->get(entry.first) == entry.second;
+            });
+        }
+        if (a->value_type() == config_value::type::LIST && !is_packed(a) && !is_packed(b)) {
+            auto a_list = dynamic_pointer_cast<const config_list>(a);
+            auto b_list = dynamic_pointer_cast<const config_list>(b);
+            return a_list->size() == b_list->size() && equal(a_list->begin(), a_list->end(), b_list->begin());
+        }
+        return typeid(*a) == typeid(*b) && *a == *b;
+    }
+
+    config_history::config_history(size_t capacity) : _capacity(capacity), _next_generation(1) {
+        if (capacity == 0) {
+            throw bug_or_broken_exception("config_history needs room for at least one generation");
+        }
+    }
+
+    uint64_t config_history::push(shared_config conf) {
+        if (!conf->is_resolved()) {
+            throw not_resolved_exception("need to config::resolve() before adding a config to its history");
+        }
+        size_t hash;
+        auto root = dynamic_pointer_cast<const config_object>(intern(conf->root(), hash));
+        _generations.push_back(make_shared<config>(move(root)));
+        if (_generations.size() > _capacity) {
+            _generations.pop_front();
+            purge();
+        }
+        return _next_generation++;
+    }
+
+    shared_value config_history::intern(shared_value const& v, size_t& hash) {
+        auto known = _by_address.find(v.get());
+        if (known != _by_address.end()) {
+            auto stored = known->second.value.lock();
+            if (stored == v) {
+                hash = known->second.hash;
+                return stored;
+            }
+        }
+
+        auto type = v->value_type();
+        hash = mix(static_cast<size_t>(type));
+        shared_value candidate = v;
+        if (type == config_value::type::OBJECT) {
+            auto object = dynamic_pointer_cast<const config_object>(v);
+            unordered_map<string, shared_value> children;
+            bool changed = false;
+            for (auto& entry : *object) {
+                size_t child_hash;
+                auto child = intern(entry.second, child_hash);
+                changed = changed || child != entry.second;
+                // summed so the hash doesn't depend on the order of the keys
+                hash += hash_combine(std::hash<string>()(entry.first), child_hash);
+                children.emplace(entry.first, move(child));
+            }
+            if (changed) {
+                candidate = make_shared<simple_config_object>(object->origin(), move(children));
+            }
+        } else if (type == config_value::type::LIST && !is_packed(v)) {
+            auto list = dynamic_pointer_cast<const config_list>(v);
+            vector<shared_value> elements;
+            elements.reserve(list->size());
+            bool changed = false;
+            for (auto& element : *list) {
+                size_t element_hash;
+                elements.push_back(intern(element, element_hash));
+                changed = changed || elements.back() != element;
+                hash = hash_combine(hash, element_hash);
+            }
+            if (changed) {
+                candidate = make_shared<simple_config_list>(list->origin(), move(elements), list->get_resolve_status());
+            }
+        } else if (type == config_value::type::LIST) {
+            // packed lists are stored as whole values, hashed by their columns
+            hash = hash_combine(hash, dynamic_pointer_cast<const simple_config_list>(v)->packed()->hash());
+        } else {
+            hash = hash_combine(hash, std::hash<string>()(v->transform_to_string()));
+        }
+        return find_or_add(move(candidate), hash);
+    }
+
+    shared_value config_history::find_or_add(shared_value v, size_t hash) {
+        auto range = _by_hash.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto stored = it->second.lock();
+            if (stored && same_content(stored, v)) {
+                return stored;
+            }
+        }
+        _by_hash.emplace(hash, v);
+        _by_address[v.get()] = interned { v, hash };
+        return v;
+    }
+
+    void config_history::purge() {
+        for (auto it = _by_hash.begin(); it != _by_hash.end();) {
+            it = it->second.expired() ? _by_hash.erase(it) : next(it);
+        }
+        for (auto it = _by_address.begin(); it != _by_address.end();) {
+            it = it->second.value.expired() ? _by_address.erase(it) : next(it);
+        }
+    }
+
+    bool config_history::contains(uint64_t generation) const {
+        return generation >= oldest() && generation != 0 && generation <= latest();
+    }
+
+    uint64_t config_history::latest() const {
+        return _next_generation - 1;
+    }
+
+    uint64_t config_history::oldest() const {
+        return _generations.empty() ? 0 : _next_generation - _generations.size();
+    }
+
+    shared_config config_history::get(uint64_t generation) const {
+        if (!contains(generation)) {
+            throw config_exception("generation " + std::to_string(generation) + " is not in the config history");
+        }
+        return _generations[generation - oldest()];
+    }
+
+    size_t config_history::shared_values() const {
+        return count_if(_by_hash.begin(), _by_hash.end(),
+                        [](pair<size_t const, weak_ptr<const config_value>> const& entry) {
+                            return !entry.second.expired();
+                        });
+    }
+
+    static void diff_values(vector<string>& elements, shared_value const& from, shared_value const& to,
+                            vector<config_change>& changes) {
+        if (from == to) {
+            return;
+        }
+        auto from_object = dynamic_pointer_cast<const config_object>(from);
+        auto to_object = dynamic_pointer_cast<const config_object>(to);
+        if (!from_object && !to_object) {
+            if (!from || !to || from->value_type() != to->value_type() || !(*from == *to)) {
+                changes.push_back({ path(elements).render(), from, to });
+            }
+            return;
+        }
+
+        // an object replaced by a leaf, or the other way round
+        if (!from_object && from) {
+            changes.push_back({ path(elements).render(), from, nullptr });
+        }
+        if (!to_object && to) {
+            changes.push_back({ path(elements).render(), nullptr, to });
+        }
+
+        vector<string> keys;
+        if (from_object) {
+            keys = from_object->key_set();
+        }
+        if (to_object) {
+            for (auto& entry : *to_object) {
+                if (!from_object || !from_object->get(entry.first)) {
+                    keys.push_back(entry.first);
+                }
+            }
+        }
+        sort(keys.begin(), keys.end());
+        for (auto& key : keys) {
+            elements.push_back(key);
+            diff_values(elements, from_object ? from_object->get(key) : nullptr,
+                        to_object ? to_object->get(key) : nullptr, changes);
+            elements.pop_back();
+        }
+    }
+
+    vector<config_change> config_history::diff(shared_config const& from, shared_config const& to) {
+        if (!from->is_resolved() || !to->is_resolved()) {
+            throw not_resolved_exception("need to config::resolve() before comparing configs");
+        }
+        vector<config_change> changes;
+        vector<string> elements;
+        diff_values(elements, from->root(), to->root(), changes);
+        return changes;
+    }
+
+    vector<config_change> config_history::diff(uint64_t from, uint64_t to) const {
+        return diff(get(from), get(to));
+    }
+
+}  // namespace hocon
@@ -0,0 +1,396 @@
+#include <hocon/config_msgpack.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/config_object.hpp>
+#include <hocon/config_list.hpp>
+#include <internal/simple_config_origin.hpp>
+#include <internal/values/config_boolean.hpp>
+#include <internal/values/config_double.hpp>
+#include <internal/values/config_null.hpp>
+#include <internal/values/config_number.hpp>
+#include <internal/values/config_string.hpp>
+#include <internal/values/packed_elements.hpp>
+#include <internal/values/simple_config_list.hpp>
+#include <internal/values/simple_config_object.hpp>
+
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace hocon {
+
+    // the extension type that carries the line number of the value after it
+    static const int8_t line_extension = 1;
+
+    // deeper documents are rejected rather than risking the stack
+    static const int max_depth = 1000;
+
+    namespace {
+
+    class msgpack_encoder {
+    public:
+        explicit msgpack_encoder(bool with_origins) : _with_origins(with_origins) {}
+
+        void value(config_value const& v) {
+            if (_with_origins) {
+                int line = v.origin() ? v.origin()->line_number() : -1;
+                if (line != _line) {
+                    put(0xd6);
+                    put(static_cast<uint8_t>(line_extension));
+                    big_endian(static_cast<uint32_t>(line), 4);
+                    _line = line;
+                }
+            }
+
+            switch (v.value_type()) {
+                case config_value::type::OBJECT:
+                    object(dynamic_cast<config_object const&>(v));
+                    break;
+                case config_value::type::LIST:
+                    list(dynamic_cast<config_list const&>(v));
+                    break;
+                case config_value::type::NUMBER:
+                    if (auto d = dynamic_cast<config_double const*>(&v)) {
+                        floating(d->double_value());
+                    } else {
+                        integer(dynamic_cast<config_number const&>(v).long_value());
+                    }
+                    break;
+                case config_value::type::BOOLEAN:
+                    put(dynamic_cast<config_boolean const&>(v).bool_value() ? 0xc3 : 0xc2);
+                    break;
+                case config_value::type::CONFIG_NULL:
+                    put(0xc0);
+                    break;
+                case config_value::type::STRING:
+                    str(v.transform_to_string());
+                    break;
+                default:
+                    throw not_resolved_exception("Can't encode a value of type " + string(v.value_type_name()));
+            }
+        }
+
+        string& result() { return _out; }
+
+    private:
+        void put(uint8_t b) {
+            _out.push_back(static_cast<char>(b));
+        }
+
+        void big_endian(uint64_t v, int bytes) {
+            for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+                put(static_cast<uint8_t>(v >> shift));
+            }
+        }
+
+        void header(uint64_t size, uint8_t fix, uint8_t fix_limit, uint8_t sized16) {
+            if (size < fix_limit) {
+                put(fix | static_cast<uint8_t>(size));
+            } else if (size <= 0xffff) {
+                put(sized16);
+                big_endian(size, 2);
+            } else {
+                put(sized16 + 1);
+                big_endian(size, 4);
+            }
+        }
+
+        void integer(int64_t v) {
+            if (v >= 0) {
+                if (v < 128) {
+                    put(static_cast<uint8_t>(v));
+                } else if (v <= 0xff) {
+                    put(0xcc);
+                    big_endian(v, 1);
+                } else if (v <= 0xffff) {
+                    put(0xcd);
+                    big_endian(v, 2);
+                } else if (v <= 0xffffffffLL) {
+                    put(0xce);
+                    big_endian(v, 4);
+                } else {
+                    put(0xcf);
+                    big_endian(v, 8);
+                }
+            } else if (v >= -32) {
+                put(static_cast<uint8_t>(v));
+            } else if (v >= numeric_limits<int8_t>::min()) {
+                put(0xd0);
+                big_endian(static_cast<uint64_t>(v), 1);
+            } else if (v >= numeric_limits<int16_t>::min()) {
+                put(0xd1);
+                big_endian(static_cast<uint64_t>(v), 2);
+            } else if (v >= numeric_limits<int32_t>::min()) {
+                put(0xd2);
+                big_endian(static_cast<uint64_t>(v), 4);
+            } else {
+                put(0xd3);
+                big_endian(static_cast<uint64_t>(v), 8);
+            }
+        }
+
+        void floating(double v) {
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            put(0xcb);
+            big_endian(bits, 8);
+        }
+
+        void str(string const& s) {
+            if (s.size() < 32) {
+                put(0xa0 | static_cast<uint8_t>(s.size()));
+            } else if (s.size() <= 0xff) {
+                put(0xd9);
+                big_endian(s.size(), 1);
+            } else {
+                header(s.size(), 0, 0, 0xda);
+            }
+            _out += s;
+        }
+
+        void object(config_object const& o) {
+            header(o.size(), 0x80, 16, 0xde);
+            for (auto const& entry : o) {
+                str(entry.first);
+                value(*entry.second);
+            }
+        }
+
+        void list(config_list const& l) {
+            header(l.size(), 0x90, 16, 0xdc);
+            // packed numbers all share the list's line, so only write them directly without origins
+            if (!_with_origins) {
+                auto longs = l.packed_longs();
+                auto doubles = l.packed_doubles();
+                if (!longs.empty()) {
+                    for (auto v : longs) {
+                        integer(v);
+                    }
+                    return;
+                } else if (!doubles.empty()) {
+                    // whole values in a double column are longs once boxed
+                    for (auto v : doubles) {
+                        if (packed_column::is_whole(v)) {
+                            integer(static_cast<int64_t>(v));
+                        } else {
+                            floating(v);
+                        }
+                    }
+                    return;
+                }
+            }
+            for (size_t i = 0; i < l.size(); ++i) {
+                value(*l.get(i));
+            }
+        }
+
+        string _out;
+        bool _with_origins;
+        int _line = -1;
+    };
+
+    class msgpack_decoder {
+    public:
+        msgpack_decoder(string const& bytes, string origin_description) :
+            _bytes(bytes), _base(make_shared<simple_config_origin>(move(origin_description))), _current(_base) {}
+
+        shared_value document() {
+            auto result = value(0);
+            if (_pos != _bytes.size()) {
+                fail("unexpected bytes after the value");
+            }
+            return result;
+        }
+
+    private:
+        [[noreturn]] void fail(string const& message) const {
+            throw parse_exception(*_base, "Invalid MessagePack at byte " + to_string(_pos) + ": " + message);
+        }
+
+        uint8_t byte() {
+            if (_pos >= _bytes.size()) {
+                fail("unexpected end of input");
+            }
+            return static_cast<uint8_t>(_bytes[_pos++]);
+        }
+
+        uint64_t big_endian(int bytes) {
+            uint64_t v = 0;
+            for (int i = 0; i < bytes; ++i) {
+                v = (v << 8) | byte();
+            }
+            return v;
+        }
+
+        size_t remaining() const {
+            return _bytes.size() - _pos;
+        }
+
+        string text(size_t size) {
+            if (size > remaining()) {
+                fail("unexpected end of input");
+            }
+            string s = _bytes.substr(_pos, size);
+            _pos += size;
+            return s;
+        }
+
+        shared_origin const& origin_at(int line) {
+            auto& origin = _lines[line];
+            if (!origin) {
+                origin = line < 0 ? _base : _base->with_line_number(line);
+            }
+            return origin;
+        }
+
+        int64_t unsigned_integer(int bytes) {
+            uint64_t v = big_endian(bytes);
+            if (v > static_cast<uint64_t>(numeric_limits<int64_t>::max())) {
+                fail("integer is too large");
+            }
+            return static_cast<int64_t>(v);
+        }
+
+        int64_t signed_integer(int bytes) {
+            uint64_t v = big_endian(bytes);
+            int shift = 64 - bytes * 8;
+            // sign extend by shifting the value to the top and back
+            return static_cast<int64_t>(v << shift) >> shift;
+        }
+
+        shared_value number(int64_t v) {
+            return config_number::new_number(_current, v, packed_column::canonical_text(v));
+        }
+
+        shared_value floating(double v) {
+            return make_shared<config_double>(_current, v, packed_column::canonical_text(v));
+        }
+
+        shared_value str(size_t size) {
+            return make_shared<config_string>(_current, text(size), config_string_type::QUOTED);
+        }
+
+        string key() {
+            uint8_t b = byte();
+            if ((b & 0xe0) == 0xa0) {
+                return text(b & 0x1f);
+            }
+            switch (b) {
+                case 0xd9: return text(big_endian(1));
+                case 0xda: return text(big_endian(2));
+                case 0xdb: return text(big_endian(4));
+                default: fail("object keys must be strings");
+            }
+        }
+
+        shared_value list(size_t size, int depth) {
+            // every element takes at least a byte, so this also bounds the allocation
+            if (size > remaining()) {
+                fail("unexpected end of input");
+            }
+            auto origin = _current;
+            vector<shared_value> values;
+            values.reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                values.push_back(value(depth + 1));
+            }
+            return simple_config_list::make_packed(move(origin), move(values));
+        }
+
+        shared_value object(size_t size, int depth) {
+            if (size > remaining() / 2) {
+                fail("unexpected end of input");
+            }
+            auto origin = _current;
+            unordered_map<string, shared_value> entries;
+            entries.reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                auto k = key();
+                entries[move(k)] = value(depth + 1);
+            }
+            return make_shared<simple_config_object>(move(origin), move(entries));
+        }
+
+        shared_value value(int depth) {
+            if (depth > max_depth) {
+                fail("values are nested too deeply");
+            }
+
+            uint8_t b = byte();
+            while (b == 0xd6 && remaining() >= 5 && static_cast<int8_t>(_bytes[_pos]) == line_extension) {
+                ++_pos;
+                _current = origin_at(static_cast<int32_t>(big_endian(4)));
+                b = byte();
+            }
+
+            if (b < 0x80) {
+                return number(b);
+            } else if (b >= 0xe0) {
+                return number(static_cast<int8_t>(b));
+            } else if ((b & 0xf0) == 0x80) {
+                return object(b & 0x0f, depth);
+            } else if ((b & 0xf0) == 0x90) {
+                return list(b & 0x0f, depth);
+            } else if ((b & 0xe0) == 0xa0) {
+                return str(b & 0x1f);
+            }
+
+            switch (b) {
+                case 0xc0: return make_shared<config_null>(_current);
+                case 0xc2: return make_shared<config_boolean>(_current, false);
+                case 0xc3: return make_shared<config_boolean>(_current, true);
+                case 0xca: {
+                    uint32_t bits = big_endian(4);
+                    float f;
+                    memcpy(&f, &bits, sizeof(f));
+                    return floating(f);
+                }
+                case 0xcb: {
+                    uint64_t bits = big_endian(8);
+                    double d;
+                    memcpy(&d, &bits, sizeof(d));
+                    return floating(d);
+                }
+                case 0xcc: return number(unsigned_integer(1));
+                case 0xcd: return number(unsigned_integer(2));
+                case 0xce: return number(unsigned_integer(4));
+                case 0xcf: return number(unsigned_integer(8));
+                case 0xd0: return number(signed_integer(1));
+                case 0xd1: return number(signed_integer(2));
+                case 0xd2: return number(signed_integer(4));
+                case 0xd3: return number(signed_integer(8));
+                case 0xd9: return str(big_endian(1));
+                case 0xda: return str(big_endian(2));
+                case 0xdb: return str(big_endian(4));
+                case 0xdc: return list(big_endian(2), depth);
+                case 0xdd: return list(big_endian(4), depth);
+                case 0xde: return object(big_endian(2), depth);
+                case 0xdf: return object(big_endian(4), depth);
+                default: fail("unsupported type " + to_string(b));
+            }
+        }
+
+        string const& _bytes;
+        size_t _pos = 0;
+        shared_origin _base;
+        shared_origin _current;
+        unordered_map<int, shared_origin> _lines;
+    };
+
+    }  // anonymous namespace
+
+    string config_msgpack::encode(shared_value const& value, bool with_origins) {
+        if (value->get_resolve_status() != resolve_status::RESOLVED) {
+            throw not_resolved_exception("Can't encode an unresolved value");
+        }
+        msgpack_encoder encoder(with_origins);
+        encoder.value(*value);
+        return move(encoder.result());
+    }
+
+    shared_value config_msgpack::decode(string const& bytes, string origin_description) {
+        return msgpack_decoder(bytes, move(origin_description)).document();
+    }
+
+}  // namespace hocon
@@ -7,9 +7,13 @@ using namespace std;
 namespace hocon {
 
     config_parse_options::config_parse_options(shared_string origin_desc,
-            bool allow_missing, shared_includer includer, config_syntax syntax) :
+            bool allow_missing, shared_includer includer, config_syntax syntax,
+            shared_source_provider source_provider, bool lazy, unsigned parse_threads,
+            shared_budget budget) :
         _syntax(syntax), _origin_description(move(origin_desc)),
-        _allow_missing(allow_missing), _includer(move(includer)) {}
+        _allow_missing(allow_missing), _includer(move(includer)),
+        _source_provider(move(source_provider)), _lazy(lazy),
+        _parse_threads(parse_threads), _budget(move(budget)) {}
 
     config_parse_options::config_parse_options(): config_parse_options(nullptr, true, nullptr, config_syntax::CONF) {}
 
@@ -19,7 +23,7 @@ namespace hocon {
 
     config_parse_options config_parse_options::set_syntax(config_syntax syntax) const
     {
-        return config_parse_options{_origin_description, _allow_missing, _includer, syntax};
+        return config_parse_options{_origin_description, _allow_missing, _includer, syntax, _source_provider, _lazy, _parse_threads, _budget};
     }
 
     config_syntax const& config_parse_options::get_syntax() const
@@ -29,7 +33,7 @@ namespace hocon {
 
     config_parse_options config_parse_options::set_origin_description(shared_string origin_description) const
     {
-        return config_parse_options{move(origin_description), _allow_missing, _includer, _syntax};
+        return config_parse_options{move(origin_description), _allow_missing, _includer, _syntax, _source_provider, _lazy, _parse_threads, _budget};
     }
 
 
@@ -49,7 +53,7 @@ namespace hocon {
 
     config_parse_options config_parse_options::set_allow_missing(bool allow_missing) const
     {
-        return config_parse_options{_origin_description, allow_missing, _includer, _syntax};
+        return config_parse_options{_origin_description, allow_missing, _includer, _syntax, _source_provider, _lazy, _parse_threads, _budget};
     }
 
     bool config_parse_options::get_allow_missing() const
@@ -59,7 +63,7 @@ namespace hocon {
 
     config_parse_options config_parse_options::set_includer(shared_includer includer) const
     {
-        return config_parse_options{ _origin_description, _allow_missing, move(includer), _syntax};
+        return config_parse_options{ _origin_description, _allow_missing, move(includer), _syntax, _source_provider, _lazy, _parse_threads, _budget};
     }
 
     config_parse_options config_parse_options::prepend_includer(shared_includer includer) const
@@ -95,4 +99,44 @@ namespace hocon {
         return _includer;
     }
 
+    config_parse_options config_parse_options::set_source_provider(shared_source_provider provider) const
+    {
+        return config_parse_options{ _origin_description, _allow_missing, _includer, _syntax, move(provider), _lazy, _parse_threads, _budget};
+    }
+
+    shared_source_provider const& config_parse_options::get_source_provider() const
+    {
+        return _source_provider;
+    }
+
+    config_parse_options config_parse_options::set_lazy(bool lazy) const
+    {
+        return config_parse_options{ _origin_description, _allow_missing, _includer, _syntax, _source_provider, lazy, _parse_threads, _budget};
+    }
+
+    bool config_parse_options::get_lazy() const
+    {
+        return _lazy;
+    }
+
+    config_parse_options config_parse_options::set_parse_threads(unsigned threads) const
+    {
+        return config_parse_options{ _origin_description, _allow_missing, _includer, _syntax, _source_provider, _lazy, threads, _budget};
+    }
+
+    unsigned config_parse_options::get_parse_threads() const
+    {
+        return _parse_threads;
+    }
+
+    config_parse_options config_parse_options::set_budget(shared_budget budget) const
+    {
+        return config_parse_options{ _origin_description, _allow_missing, _includer, _syntax, _source_provider, _lazy, _parse_threads, move(budget)};
+    }
+
+    shared_budget const& config_parse_options::get_budget() const
+    {
+        return _budget;
+    }
+
 }  // namespace hocon
@@ -1,4 +1,5 @@
 #include <internal/config_parser.hpp>
+#include <hocon/config_budget.hpp>
 #include <hocon/config_exception.hpp>
 #include <hocon/config_object.hpp>
 #include <internal/tokens.hpp>
@@ -17,6 +18,12 @@
 #include <internal/values/simple_config_object.hpp>
 #include <internal/values/simple_config_list.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+
 namespace hocon { namespace config_parser {
     using namespace std;
 
@@ -25,15 +32,21 @@ namespace hocon { namespace config_parser {
             config_parse_options options,
             shared_include_context include_context)
     {
+        unsigned threads = options.get_parse_threads();
+        if (threads == 0) {
+            threads = max(1u, thread::hardware_concurrency());
+        }
         parse_context context {options.get_syntax(), origin, document,
-                               simple_includer::make_full(options.get_includer()), include_context};
+                               simple_includer::make_full(options.get_includer()), include_context, threads,
+                               options.get_budget()};
         return context.parse();
     }
 
     parse_context::parse_context(config_syntax flavor, shared_origin origin, shared_ptr<const config_node_root> document,
-            shared_ptr<const full_includer> includer, shared_include_context include_context) :
+            shared_ptr<const full_includer> includer, shared_include_context include_context, unsigned threads,
+            shared_budget budget) :
         _line_number(1), _document(document), _includer(includer), _include_context(include_context),
-        _flavor(flavor), _base_origin(origin), array_count(0)
+        _flavor(flavor), _base_origin(origin), _threads(threads), _budget(move(budget)), array_count(0)
     {}
 
     shared_origin parse_context::line_origin() const {
@@ -83,39 +96,216 @@ namespace hocon { namespace config_parser {
         return v;
     }
 
-    shared_object parse_context::create_value_under_path(path p, shared_value value) {
-        // for path foo.bar, we are creating { "foo" : { "bar" : value } }
-        vector<shared_string> keys;
+    /**
+     * Mutable accumulator for the fields of an object while it is being parsed.
+     *
+     * A field like a.b.c = 1 descends into nested builders rather than creating
+     * { "a" : { "b" : { "c" : 1 } } } and merging it into the existing "a" with
+     * with_fallback; that way a run of dotted fields sharing a prefix costs time
+     * proportional to its length instead of re-merging the prefix on every line.
+     * Nested builders are frozen into simple_config_objects when the enclosing
+     * object is done (or when a plain value is merged over them). Since
+     * with_fallback is associative, a nested builder created over an existing
+     * value keeps that value as its base and falls back to it once when frozen.
+     */
+    class object_builder {
+    public:
+        object_builder() = default;
+        explicit object_builder(shared_value base) : _base(move(base)) {}
+
+        // Returns the value stored under key (freezing it if needed), or null.
+        shared_value get(string const& key) {
+            auto iter = _fields.find(key);
+            if (iter == _fields.end()) {
+                return nullptr;
+            }
+            return iter->second.frozen();
+        }
+
+        // Stores key = value, with any existing value for key as its fallback.
+        void merge(string const& key, shared_value value) {
+            auto iter = _fields.find(key);
+            if (iter == _fields.end()) {
+                _fields.emplace(key, entry { move(value), nullptr });
+            } else {
+                auto merged = dynamic_pointer_cast<const config_value>(value->with_fallback(iter->second.frozen()));
+                assert(merged);
+                iter->second = entry { move(merged), nullptr };
+            }
+        }
+
+        // Stores key.remaining = value, with the existing value for key as its fallback.
+        void merge_under_path(string const& key, path const& remaining, shared_value value) {
+            auto& e = _fields[key];
+            if (!e.nested) {
+                e.nested.reset(new object_builder(move(e.value)));
+                e.value = nullptr;
+            }
+            e.nested->add(remaining, move(value));
+        }
+
+        shared_object build(shared_origin origin) {
+            unordered_map<string, shared_value> values;
+            values.reserve(_fields.size());
+            for (auto& field : _fields) {
+                values.emplace(field.first, field.second.frozen());
+            }
+            return make_shared<simple_config_object>(move(origin), move(values));
+        }
+
+    private:
+        struct entry {
+            shared_value value;
+            unique_ptr<object_builder> nested;
 
-        shared_string key = p.first();
-        path remaining = p.remainder();
-        while (key != nullptr) {
-            keys.push_back(key);
+            shared_value const& frozen() {
+                if (nested) {
+                    value = nested->freeze();
+                    nested.reset();
+                }
+                return value;
+            }
+        };
+
+        void add(path const& p, shared_value value) {
+            // every object along a dotted path takes its origin from the value
+            // (without comments); repeated paths merge origins like with_fallback does
+            auto value_origin = value->origin()->with_comments(vector<string>{});
+            _origin = _origin ? simple_config_origin::merge_origins(move(value_origin), _origin) : move(value_origin);
+
+            auto key = p.first();
+            auto remaining = p.remainder();
             if (remaining.empty()) {
-                break;
+                merge(*key, move(value));
             } else {
-                key = remaining.first();
-                remaining = remaining.remainder();
+                merge_under_path(*key, remaining, move(value));
+            }
+        }
+
+        shared_value freeze() {
+            shared_value obj = build(_origin);
+            if (_base) {
+                obj = dynamic_pointer_cast<const config_value>(obj->with_fallback(_base));
+                assert(obj);
             }
+            return obj;
         }
 
-        auto current = keys.end();
-        current--;
-        auto new_value = unordered_map<string, shared_value>({ {**current, value} });
-        shared_object obj = make_shared<simple_config_object>(value->origin()->with_comments(vector<string>{}),
-                                                              new_value);
+        unordered_map<string, entry> _fields;
+        shared_value _base;
+        shared_origin _origin;
+    };
+
+    /**
+     * A field of the root object, or the object of an include, waiting to be
+     * merged in document order once the values built on other threads are
+     * ready. Fields with a build function get their value from a worker.
+     */
+    struct pending_field {
+        path field_path;
+        shared_value value;
+        shared_object included;
+        int line;
+        function<shared_value()> build;
+        vector<string> trailing_comments;
+        exception_ptr error;
+    };
+
+    // CST nodes a field's value needs before it's worth building on another thread
+    static const size_t parallel_value_nodes = 32;
+
+    static bool is_newline(shared_node const& node) {
+        auto single_token = dynamic_cast<config_node_single_token const*>(node.get());
+        return single_token && tokens::is_newline(single_token->get_token());
+    }
 
-        while (current != keys.begin()) {
-            current--;
-            new_value = unordered_map<string, shared_value>({ {**current, obj} });
-            obj = make_shared<simple_config_object>(value->origin()->with_comments(vector<string>{}), new_value);
+    /**
+     * Counts the nodes of a value and the newlines that parse_value counts
+     * while building it. Returns false if the value contains an include, which
+     * has to be processed on the thread parsing the file.
+     */
+    static bool measure_value(abstract_config_node const& n, int& newlines, size_t& nodes) {
+        ++nodes;
+        if (auto object = dynamic_cast<config_node_object const*>(&n)) {
+            for (auto const& child : object->children()) {
+                if (dynamic_cast<config_node_include const*>(child.get())) {
+                    return false;
+                } else if (auto field = dynamic_cast<config_node_field const*>(child.get())) {
+                    if (!measure_value(*field->get_value(), newlines, nodes)) {
+                        return false;
+                    }
+                } else if (is_newline(child)) {
+                    ++newlines;
+                }
+            }
+        } else if (auto array = dynamic_cast<config_node_array const*>(&n)) {
+            for (auto const& child : array->children()) {
+                if (is_newline(child)) {
+                    ++newlines;
+                } else if (auto value = dynamic_cast<abstract_config_node_value const*>(child.get())) {
+                    if (!measure_value(*value, newlines, nodes)) {
+                        return false;
+                    }
+                }
+            }
+        } else if (auto concatenation = dynamic_cast<config_node_concatenation const*>(&n)) {
+            for (auto const& child : concatenation->children()) {
+                if (auto value = dynamic_cast<abstract_config_node_value const*>(child.get())) {
+                    if (!measure_value(*value, newlines, nodes)) {
+                        return false;
+                    }
+                }
+            }
         }
+        return true;
+    }
 
-        return obj;
+    static shared_value with_trailing_comments(shared_value value, vector<string> comments) {
+        if (comments.empty()) {
+            return value;
+        }
+        auto old_origin = dynamic_pointer_cast<const simple_config_origin>(value->origin());
+        if (!old_origin) {
+            throw bug_or_broken_exception("expected origin to be simple_config_origin");
+        }
+        return value->with_origin(old_origin->append_comments(move(comments)));
     }
 
-    void parse_context::parse_include(unordered_map<string, shared_value> & values,
-                                      shared_ptr<const config_node_include> n) {
+    // builds the values of the pending fields that have a build function, on up to threads threads
+    static void build_in_parallel(vector<pending_field>& pending, unsigned threads) {
+        vector<pending_field*> work;
+        for (auto& field : pending) {
+            if (field.build) {
+                work.push_back(&field);
+            }
+        }
+
+        atomic<size_t> next { 0 };
+        auto run = [&]() {
+            for (size_t i; (i = next++) < work.size();) {
+                auto& field = *work[i];
+                try {
+                    field.value = with_trailing_comments(field.build(), move(field.trailing_comments));
+                } catch (...) {
+                    field.error = current_exception();
+                }
+                field.build = nullptr;
+            }
+        };
+        vector<thread> workers;
+        for (size_t t = 1; t < min<size_t>(threads, work.size()); ++t) {
+            workers.emplace_back(run);
+        }
+        run();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    shared_object parse_context::parse_include(shared_ptr<const config_node_include> n) {
+        if (_budget) {
+            _budget->spend_include();
+        }
         shared_object obj;
         switch (n->kind()) {
             case config_include_kind::FILE:
@@ -144,24 +334,56 @@ namespace hocon { namespace config_parser {
             auto prefix = full_current_path();
             obj = dynamic_pointer_cast<const config_object>(obj->relativized(prefix.to_string()));
         }
+        return obj;
+    }
+
+    shared_object parse_context::parse_object(shared_node_object n)
+    {
+        if (_threads > 1 && _path_stack.empty() && array_count == 0) {
+            return parse_object_in_parallel(n);
+        }
+        object_builder values;
+        auto object_origin = line_origin();
+        parse_fields(n, values, nullptr);
+        return values.build(object_origin);
+    }
+
+    shared_object parse_context::parse_object_in_parallel(shared_node_object n)
+    {
+        object_builder values;
+        auto object_origin = line_origin();
+        vector<pending_field> pending;
+        // an error found while walking the fields is reported only if no earlier field has one
+        exception_ptr walk_error;
+        try {
+            parse_fields(n, values, &pending);
+        } catch (...) {
+            walk_error = current_exception();
+        }
+
+        build_in_parallel(pending, _threads);
 
-        for (auto &pair : *obj) {
-            auto &key = pair.first;
-            auto &v = pair.second;
-            auto iter = values.find(key);
-            if (iter != values.end()) {
-                auto existing = values[key];
-                values[key] = dynamic_pointer_cast<const config_value>(v->with_fallback(existing));
+        for (auto& field : pending) {
+            if (field.error) {
+                rethrow_exception(field.error);
+            }
+            if (field.included) {
+                for (auto& pair : *field.included) {
+                    values.merge(pair.first, pair.second);
+                }
             } else {
-                values.emplace(key, v);
+                merge_field(values, field.field_path, move(field.value), field.line);
             }
         }
+        if (walk_error) {
+            rethrow_exception(walk_error);
+        }
+        return values.build(object_origin);
     }
 
-    shared_object parse_context::parse_object(shared_node_object n)
+    void parse_context::parse_fields(shared_node_object const& n, object_builder& values,
+                                     vector<pending_field>* pending)
     {
-        unordered_map<string, shared_value> values;
-        auto object_origin = line_origin();
         bool last_was_newline = false;
 
         auto nodes = n->children();
@@ -182,7 +404,14 @@ namespace hocon { namespace config_parser {
                 }
             } else if (auto include = dynamic_pointer_cast<const config_node_include>(node)) {
                 if (_flavor != config_syntax::JSON) {
-                    parse_include(values, include);
+                    auto obj = parse_include(include);
+                    if (pending) {
+                        pending->push_back(pending_field { path(), nullptr, move(obj), _line_number, nullptr, {}, nullptr });
+                    } else {
+                        for (auto &pair : *obj) {
+                            values.merge(pair.first, pair.second);
+                        }
+                    }
                     last_was_newline = false;
                 }
             } else if (auto field = dynamic_pointer_cast<const config_node_field>(node)) {
@@ -209,8 +438,22 @@ namespace hocon { namespace config_parser {
                 }
 
                 auto value_node = field->get_value();
-                // comments from the key token go to the value token
-                auto new_value = parse_value(value_node, comments);
+                shared_value new_value;
+                function<shared_value()> build;
+                int newlines = 0;
+                size_t node_count = 0;
+                if (pending && field->separator() != tokens::plus_equals_token() &&
+                    measure_value(*value_node, newlines, node_count) && node_count >= parallel_value_nodes) {
+                    // a copy of this context builds the value on a worker while we skip its lines
+                    build = [context = *this, value_node, comments]() mutable {
+                        return context.parse_value(value_node, comments);
+                    };
+                    comments.clear();
+                    _line_number += newlines;
+                } else {
+                    // comments from the key token go to the value token
+                    new_value = parse_value(value_node, comments);
+                }
 
                 if (field->separator() == tokens::plus_equals_token()) {
                     array_count -= 1;
@@ -225,15 +468,12 @@ namespace hocon { namespace config_parser {
                 }
 
                 // Grab any trailing comments on the same line
+                vector<string> trailing_comments;
                 if (i < nodes.size() - 1) {
                     ++i;
                     while (i < nodes.size()) {
                         if (auto comment = dynamic_pointer_cast<const config_node_comment>(nodes.at(i))) {
-                            auto old_origin = dynamic_pointer_cast<const simple_config_origin>(new_value->origin());
-                            if (!old_origin) {
-                                throw bug_or_broken_exception("expected origin to be simple_config_origin");
-                            }
-                            new_value = new_value->with_origin(old_origin->append_comments({comment->comment_text()}));
+                            trailing_comments.push_back(comment->comment_text());
                             break;
                         } else if (auto curr = dynamic_pointer_cast<const config_node_single_token>(nodes.at(i))) {
                             if (curr->get_token() == tokens::comma_token() ||
@@ -253,42 +493,43 @@ namespace hocon { namespace config_parser {
 
                 _path_stack.pop_back();
 
-                auto key = path.first();
-                auto remaining = path.remainder();
-
-                if (remaining.empty()) {
-                    auto existing = values.find(*key);
-                    if (existing != values.end()) {
-                        // In strict JSON, dups should be an error; while in
-                        // our custom config language, they should be merged
-                        // if the value is an object (or substitution that
-                        // could become an object).
-
-                        if (_flavor == config_syntax::JSON) {
-                            throw parse_exception(*line_origin(), "JSON does not allow duplicate fields: '" + *key + "' was already seen at " + existing->second->origin()->description());
-                        } else {
-                            new_value = dynamic_pointer_cast<const config_value>(new_value->with_fallback(existing->second));
-                            assert(new_value);
-                        }
-                    }
-                    values[*key] = new_value;
+                if (build) {
+                    pending->push_back(pending_field { path, nullptr, nullptr, _line_number, move(build),
+                                                       move(trailing_comments), nullptr });
+                } else if (pending) {
+                    pending->push_back(pending_field { path, with_trailing_comments(move(new_value), move(trailing_comments)),
+                                                       nullptr, _line_number, nullptr, {}, nullptr });
                 } else {
-                    if (_flavor == config_syntax::JSON) {
-                        throw new bug_or_broken_exception("somehow got multi-element path in JSON mode");
-                    }
-
-                    shared_object obj = create_value_under_path(remaining, new_value);
-                    auto existing = values.find(*key);
-                    if (existing != values.end()) {
-                        obj = dynamic_pointer_cast<const config_object>(obj->with_fallback(existing->second));
-                        assert(obj);
-                    }
-                    values[*key] = obj;
+                    merge_field(values, path, with_trailing_comments(move(new_value), move(trailing_comments)),
+                                _line_number);
                 }
             }
         }
+    }
+
+    void parse_context::merge_field(object_builder& values, path const& field_path, shared_value value, int line) const
+    {
+        auto key = field_path.first();
+        auto remaining = field_path.remainder();
+
+        if (remaining.empty()) {
+            // In strict JSON, dups should be an error; while in
+            // our custom config language, they should be merged
+            // if the value is an object (or substitution that
+            // could become an object).
+            if (_flavor == config_syntax::JSON) {
+                if (auto existing = values.get(*key)) {
+                    throw parse_exception(*_base_origin->with_line_number(line), "JSON does not allow duplicate fields: '" + *key + "' was already seen at " + existing->origin()->description());
+                }
+            }
+            values.merge(*key, move(value));
+        } else {
+            if (_flavor == config_syntax::JSON) {
+                throw new bug_or_broken_exception("somehow got multi-element path in JSON mode");
+            }
 
-        return make_shared<simple_config_object>(object_origin, move(values));
+            values.merge_under_path(*key, remaining, move(value));
+        }
     }
 
     static shared_ptr<const simple_config_origin> as_origin(shared_origin o) {
@@ -341,7 +582,7 @@ namespace hocon { namespace config_parser {
             values.push_back(v->with_origin(as_origin(v->origin())->append_comments(move(comments))));
         }
         --array_count;
-        return make_shared<simple_config_list>(move(array_origin), move(values));
+        return simple_config_list::make_packed(move(array_origin), move(values));
     }
 
     shared_value parse_context::parse_concatenation(shared_node_concatenation n) {
@@ -0,0 +1,144 @@
+#include <hocon/config_path_index.hpp>
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/path.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+namespace hocon {
+
+    config_path_index::config_path_index(config const& conf) {
+        if (!conf.is_resolved()) {
+            throw not_resolved_exception("need to config::resolve() before indexing its paths");
+        }
+
+        unordered_map<string, uint32_t> key_ids;
+        auto key_id = [&](string const& key) {
+            auto inserted = key_ids.emplace(key, static_cast<uint32_t>(_keys.size()));
+            if (inserted.second) {
+                _keys.push_back(key);
+            }
+            return inserted.first->second;
+        };
+
+        // Add nodes breadth-first so each node's children end up next to each other.
+        vector<pair<shared_object, uint32_t>> queue { { conf.root(), 0 } };
+        _nodes.push_back({ 0, 0, 0, 0 });
+        for (size_t next = 0; next < queue.size(); ++next) {
+            auto object = queue[next].first;
+            vector<pair<string const*, shared_value>> children;
+            for (auto& entry : *object) {
+                if (entry.second->value_type() != config_value::type::CONFIG_NULL) {
+                    children.emplace_back(&entry.first, entry.second);
+                }
+            }
+            sort(children.begin(), children.end(), [](pair<string const*, shared_value> const& a,
+                                                       pair<string const*, shared_value> const& b) {
+                return *a.first < *b.first;
+            });
+
+            uint32_t parent = queue[next].second;
+            _nodes[parent].first_child = static_cast<uint32_t>(_nodes.size());
+            _nodes[parent].child_count = static_cast<uint32_t>(children.size());
+            for (auto& child : children) {
+                auto child_object = dynamic_pointer_cast<const config_object>(child.second);
+                uint32_t leaf_count = child_object ? 0 : 1;
+                if (child_object) {
+                    queue.emplace_back(move(child_object), static_cast<uint32_t>(_nodes.size()));
+                }
+                _nodes.push_back({ key_id(*child.first), 0, 0, leaf_count });
+            }
+        }
+
+        // Children always come after their parent, so counting backwards sees them first.
+        for (size_t i = _nodes.size(); i-- > 0;) {
+            auto& n = _nodes[i];
+            for (uint32_t c = n.first_child; c < n.first_child + n.child_count; ++c) {
+                n.leaf_count += _nodes[c].leaf_count;
+            }
+        }
+        _nodes.shrink_to_fit();
+        _keys.shrink_to_fit();
+    }
+
+    int64_t config_path_index::find(string const& path_expression) const {
+        if (path_expression.empty()) {
+            return 0;
+        }
+
+        uint32_t index = 0;
+        for (path p = path::new_path(path_expression); !p.empty(); p = p.remainder()) {
+            auto& key = *p.first();
+            auto& n = _nodes[index];
+            auto first = _nodes.begin() + n.first_child;
+            auto last = first + n.child_count;
+            auto found = lower_bound(first, last, key, [&](node const& child, string const& k) {
+                return _keys[child.key] < k;
+            });
+            if (found == last || _keys[found->key] != key) {
+                return -1;
+            }
+            index = static_cast<uint32_t>(found - _nodes.begin());
+        }
+        return index;
+    }
+
+    bool config_path_index::has_prefix(string const& path_expression) const {
+        return count(path_expression) > 0;
+    }
+
+    size_t config_path_index::count(string const& path_expression) const {
+        auto index = find(path_expression);
+        return index < 0 ? 0 : _nodes[index].leaf_count;
+    }
+
+    vector<string> config_path_index::paths_with_prefix(string const& path_expression) const {
+        vector<string> result;
+        auto index = find(path_expression);
+        if (index < 0) {
+            return result;
+        }
+        result.reserve(_nodes[index].leaf_count);
+        vector<string> elements;
+        if (index > 0) {
+            for (path p = path::new_path(path_expression); !p.empty(); p = p.remainder()) {
+                elements.push_back(*p.first());
+            }
+        }
+        collect(static_cast<uint32_t>(index), elements, result);
+        return result;
+    }
+
+    void config_path_index::collect(uint32_t index, vector<string>& elements, vector<string>& result) const {
+        auto& n = _nodes[index];
+        if (n.child_count == 0) {
+            if (n.leaf_count > 0) {
+                result.push_back(path(elements).render());
+            }
+            return;
+        }
+        for (uint32_t c = n.first_child; c < n.first_child + n.child_count; ++c) {
+            if (_nodes[c].leaf_count == 0) {
+                continue;
+            }
+            elements.push_back(_keys[_nodes[c].key]);
+            collect(c, elements, result);
+            elements.pop_back();
+        }
+    }
+
+    size_t config_path_index::memory_usage() const {
+        size_t bytes = sizeof(*this) + _nodes.capacity() * sizeof(node) + _keys.capacity() * sizeof(string);
+        for (auto& key : _keys) {
+            // short keys fit in the string itself
+            if (key.capacity() > 15) {
+                bytes += key.capacity() + 1;
+            }
+        }
+        return bytes;
+    }
+
+}  // namespace hocon
@@ -0,0 +1,229 @@
+#include <hocon/config_resolve_cache.hpp>
+#include <hocon/config_object.hpp>
+#include <hocon/config_list.hpp>
+#include <internal/unmergeable.hpp>
+#include <internal/substitution_expression.hpp>
+#include <internal/values/config_concatenation.hpp>
+#include <internal/values/config_reference.hpp>
+#include <internal/values/packed_elements.hpp>
+#include <internal/values/simple_config_list.hpp>
+#include <internal/values/simple_config_object.hpp>
+
+#include <typeinfo>
+#include <unordered_set>
+
+using namespace std;
+
+namespace hocon {
+
+    // rough size of a value and its control block, not counting strings
+    static const size_t value_overhead = 96;
+
+    static size_t hash_combine(size_t seed, size_t h) {
+        return seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    // the values a concatenation or delayed merge is made of
+    static vector<shared_value> parts(shared_value const& v) {
+        if (auto concatenation = dynamic_pointer_cast<const config_concatenation>(v)) {
+            return concatenation->pieces();
+        }
+        return dynamic_pointer_cast<const unmergeable>(v)->unmerged_values();
+    }
+
+    static void add_memory_usage(shared_value const& v, unordered_set<config_value const*>& seen, size_t& bytes) {
+        if (!seen.insert(v.get()).second) {
+            return;
+        }
+        bytes += value_overhead;
+        if (auto object = dynamic_pointer_cast<const simple_config_object>(v)) {
+            for (auto& entry : *object) {
+                bytes += entry.first.size() + sizeof(entry);
+                add_memory_usage(entry.second, seen, bytes);
+            }
+        } else if (auto list = dynamic_pointer_cast<const simple_config_list>(v)) {
+            if (list->packed()) {
+                // its elements are boxed anew on every read, so count its columns instead
+                bytes += list->packed()->memory_usage();
+                return;
+            }
+            for (size_t i = 0; i < list->size(); ++i) {
+                add_memory_usage(list->get(i), seen, bytes);
+            }
+        } else if (dynamic_pointer_cast<const unmergeable>(v)) {
+            if (!dynamic_pointer_cast<const config_reference>(v)) {
+                for (auto& piece : parts(v)) {
+                    add_memory_usage(piece, seen, bytes);
+                }
+            }
+        } else if (v->value_type() == config_value::type::STRING) {
+            bytes += v->transform_to_string().size();
+        }
+    }
+
+    size_t config_resolve_cache::structural_hash(shared_value const& v) {
+        size_t hash = std::hash<string>()(typeid(*v).name());
+        if (auto reference = dynamic_pointer_cast<const config_reference>(v)) {
+            auto expression = reference->expression();
+            hash = hash_combine(hash, std::hash<string>()(expression->get_path().render()));
+            hash = hash_combine(hash, expression->optional());
+            return hash_combine(hash, static_cast<size_t>(reference->prefix_length()));
+        }
+        if (auto object = dynamic_pointer_cast<const simple_config_object>(v)) {
+            size_t children = 0;
+            for (auto& entry : *object) {
+                // summed so the hash doesn't depend on the order of the keys
+                children += hash_combine(std::hash<string>()(entry.first), structural_hash(entry.second));
+            }
+            return hash_combine(hash_combine(hash, children), object->ignores_fallbacks());
+        }
+        if (auto list = dynamic_pointer_cast<const config_list>(v)) {
+            for (size_t i = 0; i < list->size(); ++i) {
+                hash = hash_combine(hash, structural_hash(list->get(i)));
+            }
+            return hash;
+        }
+        if (dynamic_pointer_cast<const unmergeable>(v)) {
+            for (auto& piece : parts(v)) {
+                hash = hash_combine(hash, structural_hash(piece));
+            }
+            return hash;
+        }
+        return hash_combine(hash, std::hash<string>()(v->transform_to_string()));
+    }
+
+    bool config_resolve_cache::structurally_equal(shared_value const& a, shared_value const& b) {
+        if (a == b) {
+            return true;
+        }
+        if (typeid(*a) != typeid(*b)) {
+            return false;
+        }
+        if (auto a_reference = dynamic_pointer_cast<const config_reference>(a)) {
+            auto b_reference = dynamic_pointer_cast<const config_reference>(b);
+            auto a_expression = a_reference->expression();
+            auto b_expression = b_reference->expression();
+            return a_expression->get_path() == b_expression->get_path() &&
+                   a_expression->optional() == b_expression->optional() &&
+                   a_reference->prefix_length() == b_reference->prefix_length();
+        }
+        if (auto a_object = dynamic_pointer_cast<const simple_config_object>(a)) {
+            auto b_object = dynamic_pointer_cast<const simple_config_object>(b);
+            if (a_object->size() != b_object->size() || a_object->ignores_fallbacks() != b_object->ignores_fallbacks()) {
+                return false;
+            }
+            for (auto& entry : *a_object) {
+                auto other = b_object->get(entry.first);
+                if (!other || !structurally_equal(entry.second, other)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        if (auto a_list = dynamic_pointer_cast<const config_list>(a)) {
+            auto b_list = dynamic_pointer_cast<const config_list>(b);
+            if (a_list->size() != b_list->size()) {
+                return false;
+            }
+            for (size_t i = 0; i < a_list->size(); ++i) {
+                if (!structurally_equal(a_list->get(i), b_list->get(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        if (dynamic_pointer_cast<const unmergeable>(a)) {
+            auto a_pieces = parts(a);
+            auto b_pieces = parts(b);
+            if (a_pieces.size() != b_pieces.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < a_pieces.size(); ++i) {
+                if (!structurally_equal(a_pieces[i], b_pieces[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return a->transform_to_string() == b->transform_to_string();
+    }
+
+    config_resolve_cache::config_resolve_cache(size_t max_entries) :
+        _max_entries(max_entries), _hits(0), _misses(0), _memory_usage(0) { }
+
+    config_resolve_cache::statistics config_resolve_cache::stats() const {
+        lock_guard<mutex> lock(_mutex);
+        return { _hits, _misses, _entries.size(), _memory_usage };
+    }
+
+    void config_resolve_cache::clear() {
+        lock_guard<mutex> lock(_mutex);
+        _entries.clear();
+        _by_hash.clear();
+        _memory_usage = 0;
+    }
+
+    config_resolve_cache::entry_list::iterator config_resolve_cache::find(size_t hash, shared_value const& root,
+                                                                          config_resolve_options const& options) {
+        auto range = _by_hash.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto& e = *it->second;
+            if (e.use_system_environment == options.get_use_system_environment() &&
+                e.allow_unresolved == options.get_allow_unresolved() &&
+                structurally_equal(e.unresolved, root)) {
+                return it->second;
+            }
+        }
+        return _entries.end();
+    }
+
+    shared_value config_resolve_cache::find_or_resolve(shared_value const& root, config_resolve_options const& options,
+                                                       function<shared_value()> const& resolve) {
+        size_t hash = structural_hash(root);
+        {
+            lock_guard<mutex> lock(_mutex);
+            auto found = find(hash, root, options);
+            if (found != _entries.end()) {
+                ++_hits;
+                _entries.splice(_entries.begin(), _entries, found);
+                return found->resolved;
+            }
+            ++_misses;
+        }
+
+        // resolve without holding the lock; if another thread resolves an equal
+        // config meanwhile, the first result stored is kept
+        auto resolved = resolve();
+        if (_max_entries == 0) {
+            return resolved;
+        }
+        unordered_set<config_value const*> seen;
+        size_t bytes = 0;
+        add_memory_usage(root, seen, bytes);
+        add_memory_usage(resolved, seen, bytes);
+
+        lock_guard<mutex> lock(_mutex);
+        auto found = find(hash, root, options);
+        if (found != _entries.end()) {
+            return found->resolved;
+        }
+        _entries.push_front({ hash, options.get_use_system_environment(), options.get_allow_unresolved(),
+                              root, resolved, bytes });
+        _by_hash.emplace(hash, _entries.begin());
+        _memory_usage += bytes;
+        while (_entries.size() > _max_entries) {
+            auto& oldest = _entries.back();
+            auto range = _by_hash.equal_range(oldest.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == prev(_entries.end())) {
+                    _by_hash.erase(it);
+                    break;
+                }
+            }
+            _memory_usage -= oldest.memory_usage;
+            _entries.pop_back();
+        }
+        return resolved;
+    }
+
+}  // namespace hocon
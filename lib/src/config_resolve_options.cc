@@ -2,11 +2,13 @@
 
 namespace hocon {
 
-    config_resolve_options::config_resolve_options(bool use_system_environment, bool allow_unresolved) :
-        _use_system_environment(use_system_environment), _allow_unresovled(allow_unresolved) { }
+    config_resolve_options::config_resolve_options(bool use_system_environment, bool allow_unresolved,
+                                                   std::shared_ptr<config_resolve_cache> cache, shared_budget budget) :
+        _use_system_environment(use_system_environment), _allow_unresovled(allow_unresolved), _cache(std::move(cache)),
+        _budget(std::move(budget)) { }
 
     config_resolve_options config_resolve_options::set_use_system_environment(bool value) const {
-        return config_resolve_options(value, _allow_unresovled);
+        return config_resolve_options(value, _allow_unresovled, _cache, _budget);
     }
 
     bool config_resolve_options::get_use_system_environment() const {
@@ -14,11 +16,27 @@ namespace hocon {
     }
 
     config_resolve_options config_resolve_options::set_allow_unresolved(bool value) const {
-        return config_resolve_options(_use_system_environment, value);
+        return config_resolve_options(_use_system_environment, value, _cache, _budget);
     }
 
     bool config_resolve_options::get_allow_unresolved() const {
         return _allow_unresovled;
     }
 
+    config_resolve_options config_resolve_options::set_cache(std::shared_ptr<config_resolve_cache> cache) const {
+        return config_resolve_options(_use_system_environment, _allow_unresovled, std::move(cache), _budget);
+    }
+
+    std::shared_ptr<config_resolve_cache> const& config_resolve_options::get_cache() const {
+        return _cache;
+    }
+
+    config_resolve_options config_resolve_options::set_budget(shared_budget budget) const {
+        return config_resolve_options(_use_system_environment, _allow_unresovled, _cache, std::move(budget));
+    }
+
+    shared_budget const& config_resolve_options::get_budget() const {
+        return _budget;
+    }
+
 }  // namespace hocon
@@ -0,0 +1,385 @@
+#include <hocon/config_schema.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/config_object.hpp>
+#include <hocon/config_list.hpp>
+#include <internal/default_transformer.hpp>
+#include <internal/parseable.hpp>
+#include <internal/tokenizer.hpp>
+#include <internal/values/config_boolean.hpp>
+#include <internal/values/config_double.hpp>
+#include <internal/values/config_int.hpp>
+#include <internal/values/config_number.hpp>
+#include <internal/values/config_string.hpp>
+
+using namespace std;
+
+namespace hocon {
+
+    schema_node::field const* schema_node::find_field(string const& key) const {
+        for (auto const& f : _fields) {
+            if (f.key == key) {
+                return &f;
+            }
+        }
+        return nullptr;
+    }
+
+    static config_value::type value_type_of(schema_node::kind k) {
+        switch (k) {
+            case schema_node::kind::BOOLEAN: return config_value::type::BOOLEAN;
+            case schema_node::kind::INT:
+            case schema_node::kind::LONG:
+            case schema_node::kind::DOUBLE: return config_value::type::NUMBER;
+            case schema_node::kind::STRING: return config_value::type::STRING;
+            case schema_node::kind::OBJECT: return config_value::type::OBJECT;
+            case schema_node::kind::LIST: return config_value::type::LIST;
+        }
+        throw bug_or_broken_exception("Got impossible value for schema kind");
+    }
+
+    void schema_node::fill(shared_value const& value, void* target, string const& path) const {
+        auto expected = value_type_of(_kind);
+        // objects aren't converted to lists, and nothing converts to an object
+        auto v = _kind == kind::OBJECT || _kind == kind::LIST ? value : default_transformer::transform(value, expected);
+        if (v->value_type() != expected) {
+            throw wrong_type_exception(*v->origin(), path.empty() ? "root" : path,
+                                       config_value::type_name(expected), v->value_type_name());
+        }
+
+        switch (_kind) {
+            case kind::BOOLEAN:
+                *static_cast<bool*>(target) = dynamic_pointer_cast<const config_boolean>(v)->bool_value();
+                break;
+            case kind::INT:
+                *static_cast<int*>(target) = dynamic_pointer_cast<const config_number>(v)->int_value_range_checked(path);
+                break;
+            case kind::LONG:
+                *static_cast<int64_t*>(target) = dynamic_pointer_cast<const config_number>(v)->long_value();
+                break;
+            case kind::DOUBLE:
+                *static_cast<double*>(target) = dynamic_pointer_cast<const config_number>(v)->double_value();
+                break;
+            case kind::STRING:
+                *static_cast<string*>(target) = v->transform_to_string();
+                break;
+            case kind::OBJECT: {
+                auto object = dynamic_pointer_cast<const config_object>(v);
+                for (auto const& f : _fields) {
+                    auto child = object->get(f.key);
+                    if (child && child->value_type() != config_value::type::CONFIG_NULL) {
+                        f.node->fill(child, f.member(target), path.empty() ? f.key : path + "." + f.key);
+                    }
+                }
+                break;
+            }
+            case kind::LIST: {
+                auto list = dynamic_pointer_cast<const config_list>(v);
+                clear(target);
+                for (size_t i = 0; i < list->size(); ++i) {
+                    _element->fill(list->get(i), append(target), path + "[" + to_string(i) + "]");
+                }
+                break;
+            }
+        }
+    }
+
+    namespace {
+
+    // Thrown when the input needs the full parser; this exception should not leave this file
+    struct needs_parser {};
+
+    /**
+     * Stores tokens into the members of a schema. This only follows the simple
+     * subset of the grammar that plain JSON and HOCON files use, and gives up on
+     * anything else so the full parser can handle it.
+     */
+    class direct_parser {
+    public:
+        direct_parser(iterator& tokens, bool json) : _tokens(tokens), _json(json) {}
+
+        void document(schema_node const& root, void* target) {
+            expect(token_type::START);
+            auto t = next_skipping_newlines();
+            if (t->get_token_type() == token_type::OPEN_CURLY) {
+                object(&root, target, token_type::CLOSE_CURLY);
+                expect_end();
+            } else if (!_json) {
+                _peeked = t;
+                object(&root, target, token_type::END);
+            } else {
+                throw needs_parser();
+            }
+        }
+
+    private:
+        shared_token next() {
+            if (_peeked) {
+                return move(_peeked);
+            }
+            while (_tokens.has_next()) {
+                auto t = _tokens.next();
+                auto type = t->get_token_type();
+                if (type == token_type::SUBSTITUTION || type == token_type::PLUS_EQUALS ||
+                    type == token_type::PROBLEM) {
+                    throw needs_parser();
+                }
+                if (type != token_type::IGNORED_WHITESPACE && type != token_type::COMMENT) {
+                    return t;
+                }
+            }
+            throw needs_parser();
+        }
+
+        shared_token const& peek() {
+            if (!_peeked) {
+                _peeked = next();
+            }
+            return _peeked;
+        }
+
+        shared_token next_skipping_newlines() {
+            auto t = next();
+            while (t->get_token_type() == token_type::NEWLINE) {
+                t = next();
+            }
+            return t;
+        }
+
+        void expect(token_type type) {
+            if (next()->get_token_type() != type) {
+                throw needs_parser();
+            }
+        }
+
+        void expect_end() {
+            if (next_skipping_newlines()->get_token_type() != token_type::END) {
+                throw needs_parser();
+            }
+        }
+
+        /**
+         * Consumes the separator after a field or element, leaving the closing
+         * token; returns true if it was a comma.
+         */
+        bool separator(token_type closer) {
+            auto type = peek()->get_token_type();
+            if (type == token_type::COMMA || (type == token_type::NEWLINE && !_json)) {
+                _peeked = nullptr;
+                return type == token_type::COMMA;
+            } else if (type == token_type::NEWLINE) {
+                // newlines are only whitespace in JSON; a comma or the closer must follow
+                _peeked = next_skipping_newlines();
+                return separator(closer);
+            } else if (type != closer) {
+                throw needs_parser();
+            }
+            return false;
+        }
+
+        // JSON doesn't allow a comma before the closing brace or bracket
+        void closed(bool after_comma) const {
+            if (after_comma && _json) {
+                throw needs_parser();
+            }
+        }
+
+        vector<string> key(shared_token const& t) {
+            if (t->get_token_type() == token_type::UNQUOTED_TEXT && !_json) {
+                auto text = t->token_text();
+                if (text == "include") {
+                    throw needs_parser();
+                }
+                vector<string> keys;
+                size_t start = 0;
+                for (size_t dot; (dot = text.find('.', start)) != string::npos; start = dot + 1) {
+                    keys.push_back(text.substr(start, dot - start));
+                }
+                keys.push_back(text.substr(start));
+                for (auto const& k : keys) {
+                    if (k.empty()) {
+                        throw needs_parser();
+                    }
+                }
+                return keys;
+            }
+            if (tokens::is_value_with_type(t, config_value::type::STRING)) {
+                return { tokens::get_value(t)->transform_to_string() };
+            }
+            throw needs_parser();
+        }
+
+        void object(schema_node const* node, void* target, token_type closer) {
+            bool after_comma = false;
+            while (true) {
+                auto t = next_skipping_newlines();
+                if (t->get_token_type() == closer) {
+                    closed(after_comma);
+                    return;
+                }
+                auto keys = key(t);
+
+                auto sep = next();
+                if (sep->get_token_type() == token_type::OPEN_CURLY && !_json) {
+                    _peeked = sep;
+                } else if (sep->get_token_type() != token_type::COLON &&
+                           (sep->get_token_type() != token_type::EQUALS || _json)) {
+                    throw needs_parser();
+                }
+
+                // walk down a dotted path; keys not in the schema are parsed but not stored
+                schema_node const* field_node = node;
+                void* field_target = target;
+                for (auto const& k : keys) {
+                    if (!field_node) {
+                        break;
+                    }
+                    if (field_node->get_kind() != schema_node::kind::OBJECT) {
+                        throw needs_parser();
+                    }
+                    auto f = field_node->find_field(k);
+                    field_node = f ? f->node.get() : nullptr;
+                    field_target = f ? f->member(field_target) : nullptr;
+                }
+                value(field_node, field_target);
+                after_comma = separator(closer);
+            }
+        }
+
+        void list(schema_node const* node, void* target) {
+            if (node) {
+                node->clear(target);
+            }
+            bool after_comma = false;
+            while (true) {
+                auto t = next_skipping_newlines();
+                if (t->get_token_type() == token_type::CLOSE_SQUARE) {
+                    closed(after_comma);
+                    return;
+                }
+                _peeked = t;
+                value(node ? &node->element() : nullptr, node ? node->append(target) : nullptr);
+                after_comma = separator(token_type::CLOSE_SQUARE);
+            }
+        }
+
+        void value(schema_node const* node, void* target) {
+            auto t = next();
+            switch (t->get_token_type()) {
+                case token_type::OPEN_CURLY:
+                    if (node && node->get_kind() != schema_node::kind::OBJECT) {
+                        throw needs_parser();
+                    }
+                    object(node, target, token_type::CLOSE_CURLY);
+                    break;
+                case token_type::OPEN_SQUARE:
+                    if (node && node->get_kind() != schema_node::kind::LIST) {
+                        throw needs_parser();
+                    }
+                    list(node, target);
+                    break;
+                case token_type::VALUE:
+                    if (node) {
+                        scalar(*node, target, tokens::get_value(t));
+                    }
+                    break;
+                case token_type::UNQUOTED_TEXT:
+                    if (_json || (node && node->get_kind() != schema_node::kind::STRING)) {
+                        throw needs_parser();
+                    }
+                    if (node) {
+                        *static_cast<string*>(target) = t->token_text();
+                    }
+                    break;
+                default:
+                    throw needs_parser();
+            }
+
+            // anything but a separator after the value would be concatenated with it
+            auto type = peek()->get_token_type();
+            if (type != token_type::COMMA && type != token_type::NEWLINE && type != token_type::CLOSE_CURLY &&
+                type != token_type::CLOSE_SQUARE && type != token_type::END) {
+                throw needs_parser();
+            }
+        }
+
+        // only stores values that need no conversion, so the result matches the full parser
+        static void scalar(schema_node const& node, void* target, shared_value const& v) {
+            switch (node.get_kind()) {
+                case schema_node::kind::BOOLEAN:
+                    if (auto b = dynamic_pointer_cast<const config_boolean>(v)) {
+                        *static_cast<bool*>(target) = b->bool_value();
+                        return;
+                    }
+                    break;
+                case schema_node::kind::INT:
+                    if (auto i = dynamic_pointer_cast<const config_int>(v)) {
+                        *static_cast<int*>(target) = static_cast<int>(i->long_value());
+                        return;
+                    }
+                    break;
+                case schema_node::kind::LONG:
+                    if (v->value_type() == config_value::type::NUMBER && !dynamic_pointer_cast<const config_double>(v)) {
+                        *static_cast<int64_t*>(target) = dynamic_pointer_cast<const config_number>(v)->long_value();
+                        return;
+                    }
+                    break;
+                case schema_node::kind::DOUBLE:
+                    if (auto n = dynamic_pointer_cast<const config_number>(v)) {
+                        *static_cast<double*>(target) = n->double_value();
+                        return;
+                    }
+                    break;
+                case schema_node::kind::STRING:
+                    if (auto s = dynamic_pointer_cast<const config_string>(v)) {
+                        *static_cast<string*>(target) = s->transform_to_string();
+                        return;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            throw needs_parser();
+        }
+
+        iterator& _tokens;
+        bool _json;
+        shared_token _peeked;
+    };
+
+    }  // anonymous namespace
+
+    static bool parse_tokens(parseable const& input, config_parse_options const& options,
+                             schema_node const& root, void* target) {
+        if (options.get_budget()) {
+            // only the full parser counts against a budget
+            return false;
+        }
+        try {
+            auto tokens = input.tokens(options);
+            bool json = options.get_syntax() == config_syntax::JSON ||
+                        (options.get_syntax() == config_syntax::UNSPECIFIED &&
+                         input.guess_syntax() == config_syntax::JSON);
+            direct_parser(tokens, json).document(root, target);
+            return true;
+        } catch (needs_parser const&) {
+            return false;
+        } catch (config_exception const&) {
+            // let the full parser report it
+            return false;
+        }
+    }
+
+    bool schema_node::parse_direct(string const& text, config_parse_options const& options, void* target) const {
+        return parse_tokens(*parseable::new_string(text, options), options, *this, target);
+    }
+
+    bool schema_node::parse_file_direct(string const& path, config_parse_options const& options, void* target) const {
+        auto input = parseable::new_file(path, options);
+        if (options.get_syntax() == config_syntax::UNSPECIFIED && input->guess_syntax() == config_syntax::UNSPECIFIED) {
+            // parse_file_any_syntax looks for path.conf and path.json
+            return false;
+        }
+        return parse_tokens(*input, options, *this, target);
+    }
+
+}  // namespace hocon
@@ -0,0 +1,297 @@
+#include <hocon/config_source_provider.hpp>
+#include <hocon/config_bundle.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_set>
+
+using namespace std;
+
+namespace hocon {
+
+    // config_bundle::normalize_path, keeping a leading slash
+    static string normalize_name(string const& name) {
+        auto normalized = config_bundle::normalize_path(name);
+        return !name.empty() && name[0] == '/' ? "/" + normalized : normalized;
+    }
+
+    class filesystem_source_provider : public config_source_provider {
+    public:
+        bool open(string const& name, config_source& source) const override {
+            ifstream in(name, ios::binary);
+            if (!in.is_open()) {
+                return false;
+            }
+            auto contents = make_shared<string>(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+            source.bytes = { contents->data(), contents->size() };
+            source.owner = move(contents);
+            return true;
+        }
+    };
+
+    class in_memory_source_provider : public config_source_provider {
+    public:
+        in_memory_source_provider(unordered_map<string, string> sources) {
+            for (auto& entry : sources) {
+                _sources.emplace(normalize_name(entry.first), make_shared<const string>(move(entry.second)));
+            }
+        }
+
+        bool open(string const& name, config_source& source) const override {
+            auto found = _sources.find(normalize_name(name));
+            if (found == _sources.end()) {
+                return false;
+            }
+            source.bytes = { found->second->data(), found->second->size() };
+            source.owner = found->second;
+            return true;
+        }
+
+    private:
+        unordered_map<string, shared_ptr<const string>> _sources;
+    };
+
+    class bundle_source_provider : public config_source_provider {
+    public:
+        bundle_source_provider(shared_ptr<const config_bundle> bundle) : _bundle(move(bundle)) {
+            auto& path = _bundle->bundle_path();
+            auto slash = path.rfind('/');
+            _dir = slash == string::npos ? "" : path.substr(0, slash + 1);
+        }
+
+        bool open(string const& name, config_source& source) const override {
+            if (name.empty() || name[0] != '/') {
+                auto bytes = _bundle->source(name);
+                if (bytes.data) {
+                    source.bytes = bytes;
+                    source.owner = _bundle;
+                    return true;
+                }
+                return filesystem()->open(_dir + name, source);
+            }
+            return filesystem()->open(name, source);
+        }
+
+    private:
+        shared_ptr<const config_bundle> _bundle;
+        string _dir;
+    };
+
+    shared_source_provider config_source_provider::filesystem() {
+        static auto provider = make_shared<filesystem_source_provider>();
+        return provider;
+    }
+
+    shared_source_provider config_source_provider::in_memory(unordered_map<string, string> sources) {
+        return make_shared<in_memory_source_provider>(move(sources));
+    }
+
+    shared_source_provider config_source_provider::bundle(shared_ptr<const config_bundle> bundle) {
+        return make_shared<bundle_source_provider>(move(bundle));
+    }
+
+    static bool has_config_extension(string const& name) {
+        for (auto extension : { ".conf", ".json", ".gz", ".zst" }) {
+            auto size = strlen(extension);
+            if (name.size() >= size && name.compare(name.size() - size, size, extension) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The files named by include statements in a source, relative to its
+    // directory unless they're file() includes, as the includer takes them.
+    // This only looks for the keyword
+    // and a quoted name, so an include mentioned in a comment or a string is
+    // read needlessly, and one that isn't found just isn't read ahead.
+    static vector<string> scan_includes(string const& name, array_view<char> bytes) {
+        static const string keyword = "include";
+        auto slash = name.rfind('/');
+        string dir = slash == string::npos ? "" : name.substr(0, slash + 1);
+        auto space = [](char c) { return isspace(static_cast<unsigned char>(c)) != 0; };
+
+        vector<string> targets;
+        auto begin = bytes.begin(), end = bytes.end();
+        for (auto at = search(begin, end, keyword.begin(), keyword.end()); at != end;
+             at = search(at + 1, end, keyword.begin(), keyword.end())) {
+            if (at != begin && !space(at[-1]) && at[-1] != '{' && at[-1] != ',') {
+                continue;
+            }
+            auto pos = at + keyword.size();
+            auto skip = [&](string const& word) {
+                pos = find_if_not(pos, end, space);
+                if (static_cast<size_t>(end - pos) >= word.size() && equal(word.begin(), word.end(), pos)) {
+                    pos += word.size();
+                    return true;
+                }
+                return false;
+            };
+            // file() names are relative to the working directory rather than the source
+            bool from_working_dir = skip("file(");
+            if (!skip("\"")) {
+                continue;
+            }
+            auto close = find(pos, end, '"');
+            if (close == end) {
+                break;
+            }
+            string target(pos, close);
+            if (target.empty() || target.find("://") != string::npos) {
+                continue;
+            }
+            if (target[0] != '/' && !from_working_dir) {
+                target = dir + target;
+            }
+            if (has_config_extension(target)) {
+                targets.push_back(target);
+            } else {
+                targets.push_back(target + ".conf");
+                targets.push_back(target + ".json");
+            }
+        }
+        return targets;
+    }
+
+    struct prefetching_source_provider::state {
+        struct entry {
+            bool done = false;
+            bool found = false;
+            config_source source;
+            // what reading it threw, rethrown to whoever opens it
+            exception_ptr error;
+        };
+
+        shared_source_provider fallback;
+        mutex lock;
+        condition_variable changed;
+        deque<string> queue;
+        unordered_map<string, entry> entries;
+        unordered_set<string> opened_names;
+        vector<string> opened;
+        bool stopping = false;
+
+        // call with lock held
+        void enqueue(string const& name) {
+            auto key = normalize_name(name);
+            if (entries.emplace(key, entry()).second) {
+                queue.push_back(key);
+                changed.notify_all();
+            }
+        }
+
+        void read(string const& name, unique_lock<mutex>& held) {
+            held.unlock();
+            config_source source;
+            bool found = false;
+            vector<string> includes;
+            exception_ptr error;
+            try {
+                found = fallback->open(name, source);
+                if (found) {
+                    includes = scan_includes(name, source.bytes);
+                }
+            } catch (...) {
+                error = current_exception();
+            }
+            held.lock();
+
+            auto& e = entries[name];
+            e.done = true;
+            e.found = found;
+            e.source = move(source);
+            e.error = error;
+            for (auto const& include : includes) {
+                enqueue(include);
+            }
+            changed.notify_all();
+        }
+
+        void work() {
+            unique_lock<mutex> held(lock);
+            while (true) {
+                changed.wait(held, [&] { return stopping || !queue.empty(); });
+                if (stopping) {
+                    return;
+                }
+                auto name = move(queue.front());
+                queue.pop_front();
+                read(name, held);
+            }
+        }
+    };
+
+    prefetching_source_provider::prefetching_source_provider(vector<string> const& names,
+                                                             shared_source_provider fallback, unsigned threads) :
+        _state(make_shared<state>())
+    {
+        _state->fallback = move(fallback);
+        prefetch(names);
+        for (unsigned i = 0; i < max(1u, threads); ++i) {
+            _workers.emplace_back([state = _state] { state->work(); });
+        }
+    }
+
+    prefetching_source_provider::~prefetching_source_provider() {
+        {
+            lock_guard<mutex> held(_state->lock);
+            _state->stopping = true;
+        }
+        _state->changed.notify_all();
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    bool prefetching_source_provider::open(string const& name, config_source& source) const {
+        auto key = normalize_name(name);
+        unique_lock<mutex> held(_state->lock);
+        if (_state->opened_names.insert(key).second) {
+            _state->opened.push_back(key);
+        }
+
+        auto found = _state->entries.find(key);
+        if (found == _state->entries.end()) {
+            // nothing knew about it in time; read it here rather than wait behind the queue
+            _state->entries.emplace(key, state::entry());
+            _state->read(key, held);
+        } else if (!found->second.done) {
+            auto queued = find(_state->queue.begin(), _state->queue.end(), key);
+            if (queued != _state->queue.end()) {
+                _state->queue.erase(queued);
+                _state->read(key, held);
+            } else {
+                _state->changed.wait(held, [&] { return _state->entries[key].done; });
+            }
+        }
+
+        auto const& e = _state->entries[key];
+        if (e.error) {
+            rethrow_exception(e.error);
+        }
+        if (e.found) {
+            source = e.source;
+        }
+        return e.found;
+    }
+
+    void prefetching_source_provider::prefetch(vector<string> const& names) const {
+        lock_guard<mutex> held(_state->lock);
+        for (auto const& name : names) {
+            _state->enqueue(name);
+        }
+    }
+
+    vector<string> prefetching_source_provider::opened() const {
+        lock_guard<mutex> held(_state->lock);
+        return _state->opened;
+    }
+
+}  // namespace hocon
@@ -0,0 +1,247 @@
+#include <internal/decompressing_stream.hpp>
+#include <internal/simple_config_origin.hpp>
+#include <hocon/config_exception.hpp>
+
+#include <streambuf>
+#include <vector>
+
+#ifdef HOCON_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HOCON_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+namespace hocon {
+
+    static const size_t chunk_size = 64 * 1024;
+
+    static bool ends_with(string const& s, string const& ending) {
+        return s.size() >= ending.size() && s.compare(s.size() - ending.size(), ending.size(), ending) == 0;
+    }
+
+    compression compression_from_extension(string const& name) {
+        if (ends_with(name, ".gz")) {
+            return compression::GZIP;
+        } else if (ends_with(name, ".zst")) {
+            return compression::ZSTD;
+        }
+        return compression::NONE;
+    }
+
+    string strip_compression_extension(string const& name) {
+        switch (compression_from_extension(name)) {
+            case compression::GZIP: return name.substr(0, name.size() - 3);
+            case compression::ZSTD: return name.substr(0, name.size() - 4);
+            default: return name;
+        }
+    }
+
+    compression detect_compression(istream& in) {
+        auto start = in.tellg();
+        unsigned char magic[4] = {};
+        in.read(reinterpret_cast<char*>(magic), sizeof(magic));
+        auto count = in.gcount();
+        in.clear();
+        in.seekg(start);
+        if (count >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+            return compression::GZIP;
+        } else if (count == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+            return compression::ZSTD;
+        }
+        return compression::NONE;
+    }
+
+    bool compression_supported(compression format) {
+        switch (format) {
+#ifdef HOCON_HAVE_ZLIB
+            case compression::GZIP: return true;
+#endif
+#ifdef HOCON_HAVE_ZSTD
+            case compression::ZSTD: return true;
+#endif
+            case compression::NONE: return true;
+            default: return false;
+        }
+    }
+
+    /**
+     * A streambuf that refills its get area by decompressing the next chunk of
+     * the underlying stream; subclasses do the decompressing.
+     */
+    class decompressing_buffer : public streambuf {
+    public:
+        decompressing_buffer(unique_ptr<istream> in, string name) :
+            _in(move(in)), _name(move(name)), _input(chunk_size), _output(chunk_size) { }
+
+        virtual ~decompressing_buffer() = default;
+
+    protected:
+        int_type underflow() override {
+            if (gptr() < egptr()) {
+                return traits_type::to_int_type(*gptr());
+            }
+            size_t produced = 0;
+            while (produced == 0 && !_done) {
+                produced = inflate_chunk();
+            }
+            if (produced == 0) {
+                return traits_type::eof();
+            }
+            setg(_output.data(), _output.data(), _output.data() + produced);
+            return traits_type::to_int_type(*gptr());
+        }
+
+        /** Decompresses into _output, returning how many bytes it produced. */
+        virtual size_t inflate_chunk() = 0;
+
+        /** Reads the next chunk of input, returning its size; 0 at the end. */
+        size_t read_input() {
+            _in->read(_input.data(), _input.size());
+            return static_cast<size_t>(_in->gcount());
+        }
+
+        [[noreturn]] void fail(string const& message) const {
+            throw io_exception(simple_config_origin(_name), message);
+        }
+
+        unique_ptr<istream> _in;
+        string _name;
+        vector<char> _input;
+        vector<char> _output;
+        bool _done = false;
+    };
+
+#ifdef HOCON_HAVE_ZLIB
+    class gzip_buffer : public decompressing_buffer {
+    public:
+        gzip_buffer(unique_ptr<istream> in, string name) : decompressing_buffer(move(in), move(name)) {
+            _stream = {};
+            // 16 selects the gzip wrapper
+            if (inflateInit2(&_stream, 16 + MAX_WBITS) != Z_OK) {
+                fail("could not initialize gzip decompression");
+            }
+        }
+
+        ~gzip_buffer() {
+            inflateEnd(&_stream);
+        }
+
+    protected:
+        size_t inflate_chunk() override {
+            if (_stream.avail_in == 0) {
+                _stream.next_in = reinterpret_cast<Bytef*>(_input.data());
+                _stream.avail_in = static_cast<uInt>(read_input());
+                if (_stream.avail_in == 0) {
+                    if (!_member_done) {
+                        fail("truncated gzip data");
+                    }
+                    _done = true;
+                    return 0;
+                }
+            }
+            if (_member_done) {
+                // concatenated gzip members are read as one stream
+                inflateReset(&_stream);
+                _member_done = false;
+            }
+            _stream.next_out = reinterpret_cast<Bytef*>(_output.data());
+            _stream.avail_out = static_cast<uInt>(_output.size());
+            int rc = inflate(&_stream, Z_NO_FLUSH);
+            if (rc == Z_STREAM_END) {
+                _member_done = true;
+            } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                fail(string("corrupt gzip data") + (_stream.msg ? string(": ") + _stream.msg : ""));
+            }
+            return _output.size() - _stream.avail_out;
+        }
+
+    private:
+        z_stream _stream;
+        bool _member_done = false;
+    };
+#endif
+
+#ifdef HOCON_HAVE_ZSTD
+    class zstd_buffer : public decompressing_buffer {
+    public:
+        zstd_buffer(unique_ptr<istream> in, string name) :
+            decompressing_buffer(move(in), move(name)), _stream(ZSTD_createDStream()) {
+            if (!_stream || ZSTD_isError(ZSTD_initDStream(_stream))) {
+                fail("could not initialize zstd decompression");
+            }
+        }
+
+        ~zstd_buffer() {
+            ZSTD_freeDStream(_stream);
+        }
+
+    protected:
+        size_t inflate_chunk() override {
+            if (_in_buffer.pos == _in_buffer.size) {
+                _in_buffer = { _input.data(), read_input(), 0 };
+                if (_in_buffer.size == 0) {
+                    if (_frame_pending) {
+                        fail("truncated zstd data");
+                    }
+                    _done = true;
+                    return 0;
+                }
+            }
+            ZSTD_outBuffer out = { _output.data(), _output.size(), 0 };
+            size_t rc = ZSTD_decompressStream(_stream, &out, &_in_buffer);
+            if (ZSTD_isError(rc)) {
+                fail(string("corrupt zstd data: ") + ZSTD_getErrorName(rc));
+            }
+            // 0 means a frame was completed and flushed
+            _frame_pending = rc != 0;
+            return out.pos;
+        }
+
+    private:
+        ZSTD_DStream* _stream;
+        ZSTD_inBuffer _in_buffer = { nullptr, 0, 0 };
+        bool _frame_pending = false;
+    };
+#endif
+
+    /** An istream that owns its decompressing_buffer and passes on its exceptions. */
+    class decompressed_istream : public istream {
+    public:
+        decompressed_istream(unique_ptr<decompressing_buffer> buffer) : istream(buffer.get()), _buffer(std::move(buffer)) {
+            // errors reading the compressed data are thrown from the buffer;
+            // without this the istream would report them as the end of the input
+            exceptions(ios::badbit);
+        }
+
+    private:
+        unique_ptr<decompressing_buffer> _buffer;
+    };
+
+    unique_ptr<istream> decompressing_stream(unique_ptr<istream> in, string const& name) {
+        auto format = detect_compression(*in);
+        if (format == compression::NONE) {
+            format = compression_from_extension(name);
+        }
+        switch (format) {
+            case compression::NONE:
+                return in;
+#ifdef HOCON_HAVE_ZLIB
+            case compression::GZIP:
+                return unique_ptr<istream>(new decompressed_istream(
+                    unique_ptr<decompressing_buffer>(new gzip_buffer(move(in), name))));
+#endif
+#ifdef HOCON_HAVE_ZSTD
+            case compression::ZSTD:
+                return unique_ptr<istream>(new decompressed_istream(
+                    unique_ptr<decompressing_buffer>(new zstd_buffer(move(in), name))));
+#endif
+            default:
+                throw io_exception(simple_config_origin(name), string("this build can't read ") +
+                                   (format == compression::GZIP ? "gzip" : "zstd") + " compressed files");
+        }
+    }
+
+}  // namespace hocon
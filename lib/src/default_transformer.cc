@@ -14,51 +14,61 @@ using namespace std;
 
 namespace hocon {
 
+    // value coerced to the requested type, or value itself if it can't be
+    static shared_value coerce_string(shared_value const& value, config_value::type requested) {
+        string s = value->transform_to_string();
+        std::stringstream number_converter;
+        switch (requested) {
+            case config_value::type::NUMBER:
+                number_converter << s;
+                int64_t i;
+                number_converter >> i;
+                if (!number_converter.fail()) {
+                    return make_shared<config_long>(value->origin(), i, s);
+                }
+                number_converter.str(std::string());
+
+                number_converter << s;
+                double d;
+                number_converter >> d;
+                if (!number_converter.fail()) {
+                    return make_shared<config_double>(value->origin(), d, s);
+                }
+                break;
+            case config_value::type::CONFIG_NULL:
+                if (s == "null") {
+                    return make_shared<config_null>(value->origin());
+                }
+                break;
+            case config_value::type::BOOLEAN:
+                if (s == "true" || s == "yes" || s == "on") {
+                    return make_shared<config_boolean>(value->origin(), true);
+                } else if (s == "false" || s == "no" || s == "off") {
+                    return make_shared<config_boolean>(value->origin(), false);
+                }
+                break;
+            case config_value::type::LIST:
+                // can't go STRING to LIST automatically
+                break;
+            case config_value::type::OBJECT:
+                // can't go STRING ot OBJECT automatically
+                break;
+            case config_value::type::STRING:
+                // no-op, already a string
+                break;
+            case config_value::type::UNSPECIFIED:
+                throw config_exception("No target value type specified");
+        }
+        return value;
+    }
+
     shared_value default_transformer::transform(shared_value value, config_value::type requested) {
         if (value->value_type() == config_value::type::STRING) {
-            string s = value->transform_to_string();
-            std::stringstream number_converter;
-            switch (requested) {
-                case config_value::type::NUMBER:
-                    number_converter << s;
-                    int64_t i;
-                    number_converter >> i;
-                    if (!number_converter.fail()) {
-                        return make_shared<config_long>(value->origin(), i, s);
-                    }
-                    number_converter.str(std::string());
-
-                    number_converter << s;
-                    double d;
-                    number_converter >> d;
-                    if (!number_converter.fail()) {
-                        return make_shared<config_double>(value->origin(), d, s);
-                    }
-                    break;
-                case config_value::type::CONFIG_NULL:
-                    if (s == "null") {
-                        return make_shared<config_null>(value->origin());
-                    }
-                    break;
-                case config_value::type::BOOLEAN:
-                    if (s == "true" || s == "yes" || s == "on") {
-                        return make_shared<config_boolean>(value->origin(), true);
-                    } else if (s == "false" || s == "no" || s == "off") {
-                        return make_shared<config_boolean>(value->origin(), false);
-                    }
-                    break;
-                case config_value::type::LIST:
-                    // can't go STRING to LIST automatically
-                    break;
-                case config_value::type::OBJECT:
-                    // can't go STRING ot OBJECT automatically
-                    break;
-                case config_value::type::STRING:
-                    // no-op, already a string
-                    break;
-                case config_value::type::UNSPECIFIED:
-                    throw config_exception("No target value type specified");
+            if (auto str = dynamic_pointer_cast<const config_string>(value)) {
+                // strings are immutable, so the coercion is kept on the string
+                return str->memoized_coercion(requested, [&]() { return coerce_string(value, requested); });
             }
+            return coerce_string(value, requested);
         } else if (requested == config_value::type::STRING) {
             // if we converted null to string here, then you wouldn't properly get a missing value error
             // i you tried to ge a null value as a string
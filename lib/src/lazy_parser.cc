@@ -0,0 +1,374 @@
+#include <internal/lazy_parser.hpp>
+#include <internal/config_document_parser.hpp>
+#include <internal/config_parser.hpp>
+#include <internal/tokenizer.hpp>
+#include <internal/values/simple_config_object.hpp>
+
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace hocon { namespace lazy_parser {
+
+    // Everything a deferred body needs to be parsed later.
+    struct source {
+        shared_ptr<const string> text;
+        shared_origin origin;
+        config_parse_options options;
+        shared_include_context include_context;
+        shared_ptr<const void> owner;
+    };
+
+    // An object body, from its opening brace to just after its closing one.
+    struct body {
+        string key;
+        size_t begin;
+        size_t end;
+        int line;
+    };
+
+    /**
+     * The first pass over an object: finds the root object's keys and which of
+     * them have object values that can be deferred. It follows the tokenizer's
+     * rules for quotes and comments, and gives up on anything it doesn't
+     * understand so the parser can deal with it.
+     */
+    class scanner {
+    public:
+        scanner(string const& text, size_t begin, size_t end, int first_line, bool json) :
+            _text(text), _pos(begin), _end(end), _line(first_line), _json(json) {}
+
+        /** Returns false if the whole document must be parsed up front. */
+        bool scan(vector<body>& bodies) {
+            skip_space(true);
+            bool braced = at(_pos) == '{';
+            if (braced) {
+                ++_pos;
+            } else if (_json || at(_pos) == '[') {
+                return false;
+            }
+
+            unordered_map<string, int> key_counts;
+            vector<body> candidates;
+            while (true) {
+                // fields are separated by newlines and commas
+                while (skip_space(true), at(_pos) == ',') {
+                    ++_pos;
+                }
+                if (_pos >= _end) {
+                    if (braced) {
+                        return false;
+                    }
+                    break;
+                }
+                if (braced && at(_pos) == '}') {
+                    break;
+                }
+
+                string key;
+                bool plain = true;
+                if (!read_key(key, plain)) {
+                    return false;
+                }
+                ++key_counts[key.substr(0, plain ? string::npos : key.find('.'))];
+
+                skip_space(false);
+                char c = at(_pos);
+                if (c == ':' || c == '=') {
+                    ++_pos;
+                    skip_space(false);
+                } else if (c != '{') {
+                    return false;
+                }
+
+                if (at(_pos) == '{') {
+                    body b { key, _pos, 0, _line };
+                    if (!skip_balanced()) {
+                        return false;
+                    }
+                    b.end = _pos;
+                    // an object concatenated with something else isn't deferred
+                    skip_space(false);
+                    char next = at(_pos);
+                    if (plain && (_pos >= _end || next == '\n' || next == ',' || next == '}' || comment_at(_pos))) {
+                        candidates.push_back(move(b));
+                    }
+                }
+                if (!skip_value(braced)) {
+                    return false;
+                }
+            }
+
+            // duplicate keys are merged, so only keys that appear once can be deferred
+            for (auto& b : candidates) {
+                if (key_counts[b.key] == 1) {
+                    bodies.push_back(move(b));
+                }
+            }
+            return true;
+        }
+
+    private:
+        char at(size_t i) const {
+            return i < _end ? _text[i] : '\0';
+        }
+
+        bool comment_at(size_t i) const {
+            return at(i) == '#' || (at(i) == '/' && at(i + 1) == '/');
+        }
+
+        static bool ends_unquoted(char c) {
+            return string(" \t\r\n$\"{}[]:=,+#`^?!@*&\\").find(c) != string::npos;
+        }
+
+        // skips whitespace and comments, and newlines if asked
+        void skip_space(bool newlines) {
+            while (_pos < _end) {
+                char c = _text[_pos];
+                if (c == '\n') {
+                    if (!newlines) {
+                        return;
+                    }
+                    ++_line;
+                    ++_pos;
+                } else if (c == ' ' || c == '\t' || c == '\r') {
+                    ++_pos;
+                } else if (comment_at(_pos) && !_json) {
+                    while (_pos < _end && _text[_pos] != '\n') {
+                        ++_pos;
+                    }
+                } else {
+                    return;
+                }
+            }
+        }
+
+        bool read_key(string& key, bool& plain) {
+            if (at(_pos) == '"') {
+                if (at(_pos + 1) == '"' && at(_pos + 2) == '"') {
+                    return false;
+                }
+                size_t start = ++_pos;
+                while (_pos < _end && _text[_pos] != '"') {
+                    if (_text[_pos] == '\\' || _text[_pos] == '\n') {
+                        // the parser unescapes keys; no need to do it here too
+                        return false;
+                    }
+                    ++_pos;
+                }
+                if (_pos >= _end) {
+                    return false;
+                }
+                key = _text.substr(start, _pos++ - start);
+                return true;
+            }
+            if (_json) {
+                return false;
+            }
+            size_t start = _pos;
+            while (_pos < _end && !ends_unquoted(_text[_pos]) && !comment_at(_pos)) {
+                ++_pos;
+            }
+            key = _text.substr(start, _pos - start);
+            plain = key.find('.') == string::npos;
+            return !key.empty() && key != "include";
+        }
+
+        /**
+         * Skips a string, comment, substitution or unquoted word at _pos, or
+         * returns false if it's something the first pass won't defer around.
+         */
+        bool skip_token(bool& skipped) {
+            skipped = true;
+            char c = at(_pos);
+            if (_pos >= _end) {
+                skipped = false;
+            } else if (c == '"') {
+                return skip_string();
+            } else if (comment_at(_pos)) {
+                if (_json) {
+                    return false;
+                }
+                skip_space(false);
+            } else if ((c == '$' && at(_pos + 1) == '{') || (c == '+' && at(_pos + 1) == '=')) {
+                return false;
+            } else if (!ends_unquoted(c) && !isdigit(static_cast<unsigned char>(c)) && c != '-' && c != '.') {
+                size_t start = _pos;
+                while (_pos < _end && !ends_unquoted(_text[_pos]) && !comment_at(_pos)) {
+                    ++_pos;
+                }
+                return _text.compare(start, _pos - start, "include") != 0;
+            } else {
+                skipped = false;
+            }
+            return true;
+        }
+
+        bool skip_string() {
+            if (at(_pos + 1) == '"' && at(_pos + 2) == '"') {
+                // three or more quotes end the string at the next character that isn't one
+                _pos += 3;
+                int quotes = 0;
+                while (_pos < _end) {
+                    char c = _text[_pos];
+                    if (c == '"') {
+                        ++quotes;
+                    } else if (quotes >= 3) {
+                        return true;
+                    } else {
+                        quotes = 0;
+                        if (c == '\n') {
+                            ++_line;
+                        }
+                    }
+                    ++_pos;
+                }
+                return quotes >= 3;
+            }
+            ++_pos;
+            while (_pos < _end) {
+                char c = _text[_pos];
+                if (c == '\\') {
+                    // the tokenizer takes four characters after \u whatever they are
+                    _pos += at(_pos + 1) == 'u' ? 6 : 2;
+                } else if (c == '\n') {
+                    return false;
+                } else {
+                    ++_pos;
+                    if (c == '"') {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // skips from an opening brace or bracket to just after the one that matches it
+        bool skip_balanced() {
+            vector<char> closers;
+            do {
+                bool skipped;
+                if (!skip_token(skipped)) {
+                    return false;
+                }
+                if (skipped) {
+                    continue;
+                }
+                char c = at(_pos);
+                if (c == '{' || c == '[') {
+                    closers.push_back(c == '{' ? '}' : ']');
+                } else if (c == '}' || c == ']') {
+                    if (closers.empty() || closers.back() != c) {
+                        return false;
+                    }
+                    closers.pop_back();
+                } else if (c == '\n') {
+                    ++_line;
+                } else if (_pos >= _end) {
+                    return false;
+                }
+                ++_pos;
+            } while (!closers.empty());
+            return true;
+        }
+
+        // skips the rest of a field's value, up to the newline, comma or brace that ends it
+        bool skip_value(bool braced) {
+            while (true) {
+                bool skipped;
+                if (!skip_token(skipped)) {
+                    return false;
+                }
+                if (skipped) {
+                    continue;
+                }
+                char c = at(_pos);
+                if (_pos >= _end || c == '\n' || c == ',' || (braced && c == '}')) {
+                    return true;
+                } else if (c == '{' || c == '[') {
+                    if (!skip_balanced()) {
+                        return false;
+                    }
+                } else if (c == '}' || c == ']') {
+                    return false;
+                } else {
+                    ++_pos;
+                }
+            }
+        }
+
+        string const& _text;
+        size_t _pos;
+        size_t _end;
+        int _line;
+        bool _json;
+    };
+
+    static shared_value parse_up_front(source const& src, string text, int first_line) {
+        token_iterator tokens(src.origin, unique_ptr<istream>(new istringstream(move(text))),
+                              src.options.get_syntax() != config_syntax::JSON, first_line);
+        auto document = config_document_parser::parse(move(tokens), src.origin, src.options);
+        return config_parser::parse(document, src.origin, src.options, src.include_context);
+    }
+
+    // parses text[begin, end), or returns null if it has to be parsed up front
+    static shared_value parse_range(shared_ptr<const source> const& src, size_t begin, size_t end, int first_line) {
+        string const& text = *src->text;
+        vector<body> bodies;
+        scanner s(text, begin, end, first_line, src->options.get_syntax() == config_syntax::JSON);
+        if (!s.scan(bodies)) {
+            return nullptr;
+        }
+        if (bodies.empty()) {
+            return parse_up_front(*src, text.substr(begin, end - begin), first_line);
+        }
+
+        // leave each deferred body empty, keeping its newlines so the lines after it stay the same
+        string skeleton;
+        skeleton.reserve(end - begin);
+        size_t copied = begin;
+        for (auto const& b : bodies) {
+            skeleton.append(text, copied, b.begin + 1 - copied);
+            for (size_t i = b.begin + 1; i + 1 < b.end; ++i) {
+                if (text[i] == '\n') {
+                    skeleton.push_back('\n');
+                }
+            }
+            copied = b.end - 1;
+        }
+        skeleton.append(text, copied, end - copied);
+
+        auto root = dynamic_pointer_cast<const simple_config_object>(parse_up_front(*src, move(skeleton), first_line));
+        if (!root) {
+            return nullptr;
+        }
+        auto entries = root->entry_set();
+        for (auto const& b : bodies) {
+            auto it = entries.find(b.key);
+            if (it == entries.end() || !dynamic_pointer_cast<const simple_config_object>(it->second)) {
+                return nullptr;
+            }
+            size_t body_begin = b.begin, body_end = b.end;
+            int line = b.line;
+            it->second = make_shared<simple_config_object>(it->second->origin(), [src, body_begin, body_end, line]() {
+                auto parsed = parse_range(src, body_begin, body_end, line);
+                if (!parsed) {
+                    parsed = parse_up_front(*src, src->text->substr(body_begin, body_end - body_begin), line);
+                }
+                return dynamic_pointer_cast<const simple_config_object>(parsed)->entry_set();
+            });
+        }
+        return make_shared<simple_config_object>(root->origin(), move(entries));
+    }
+
+    shared_value parse(shared_ptr<const string> text, shared_origin origin, config_parse_options options,
+                       shared_include_context include_context, shared_ptr<const void> owner) {
+        size_t size = text->size();
+        auto src = make_shared<const source>(source { move(text), move(origin), move(options),
+                                                      move(include_context), move(owner) });
+        return parse_range(src, 0, size, 1);
+    }
+
+}}  // namespace hocon::lazy_parser
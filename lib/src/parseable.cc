@@ -4,15 +4,21 @@
 #include <internal/nodes/config_node_object.hpp>
 #include <internal/simple_config_document.hpp>
 #include <internal/values/simple_config_object.hpp>
+#include <hocon/config_budget.hpp>
 #include <hocon/config_exception.hpp>
 #include <internal/tokenizer.hpp>
 #include <internal/simple_includer.hpp>
 #include <internal/config_document_parser.hpp>
 #include <internal/simple_include_context.hpp>
 #include <internal/config_parser.hpp>
+#include <internal/lazy_parser.hpp>
+#include <hocon/config_source_provider.hpp>
+#include <internal/decompressing_stream.hpp>
 #include <vector>
 #include <numeric>
 #include <fstream>
+#include <iterator>
+#include <thread>
 
 using namespace std;
 
@@ -26,26 +32,6 @@ static bool ends_with(std::string const &fullString, std::string const &ending)
     }
 }
 
-thread_local std::map< void*, std::shared_ptr< void > > thread_specific_ptr_data;
-
-template< typename T >
-class thread_specific_ptr {
-public:
-    T* get() const
-    {
-        auto it = thread_specific_ptr_data.find((void*)this);
-        if (it != thread_specific_ptr_data.end())
-            return static_cast< T* >(it->second.get());
-        return nullptr;
-    }
-    void reset(T* v) {
-        thread_specific_ptr_data[this].reset(v);
-    }
-    void reset() {
-        thread_specific_ptr_data[this].reset();
-    }
-};
-
 class scope_exit {
 public:
     scope_exit(const std::function<void()>& f) : f_(f) {}
@@ -58,6 +44,48 @@ namespace hocon {
 
     const int parseable::MAX_INCLUDE_DEPTH = 50;
 
+    // With more than one parse thread, inputs at least this big are tokenized on them.
+    static const streamoff parallel_tokenize_size = 4 * 1024 * 1024;
+
+    static token_iterator tokenize(shared_origin origin, unique_ptr<istream> stream, config_syntax syntax,
+                                   config_parse_options const& options) {
+        unsigned threads = options.get_parse_threads();
+        if (threads == 0) {
+            threads = thread::hardware_concurrency();
+        }
+        auto start = threads > 1 ? stream->tellg() : streampos(-1);
+        if (start >= 0) {
+            stream->seekg(0, ios::end);
+            streamoff size = stream->tellg() - start;
+            stream->clear();
+            stream->seekg(start);
+            if (size >= parallel_tokenize_size) {
+                string input(static_cast<size_t>(size), '\0');
+                stream->read(&input[0], size);
+                input.resize(static_cast<size_t>(stream->gcount()));
+                return token_iterator::tokenize_parallel(move(origin), move(input), syntax, threads);
+            }
+        }
+        return token_iterator(move(origin), move(stream), syntax);
+    }
+
+    // Reads stream a block at a time, counting it against the budget, so an
+    // oversized input fails before much more than the limit is read.
+    static unique_ptr<istream> read_within(unique_ptr<istream> stream, config_budget& budget) {
+        if (!budget.limits().max_bytes) {
+            return stream;
+        }
+        string input;
+        char block[64 * 1024];
+        while (*stream) {
+            stream->read(block, sizeof(block));
+            auto count = static_cast<size_t>(stream->gcount());
+            budget.spend_bytes(count);
+            input.append(block, count);
+        }
+        return unique_ptr<istream>(new istringstream(move(input)));
+    }
+
     shared_ptr<parseable> parseable::new_file(std::string input_file_path, config_parse_options options) {
         return make_shared<parseable_file>(move(input_file_path),  move(options));
     }
@@ -146,14 +174,6 @@ namespace hocon {
         return typeid(*this).name();
     }
 
-    void parseable::set_cur_dir(std::string dir) const {
-        _include_context->set_cur_dir(move(dir));
-    }
-
-    std::string parseable::get_cur_dir() const {
-        return _include_context->get_cur_dir();
-    }
-
     void parseable::separate_filepath(const std::string& path, std::string* file_dir, std::string* file_name) const {
         char sep = '/';
         size_t i = path.rfind(sep, path.length());
@@ -179,27 +199,21 @@ namespace hocon {
     }
 
     shared_object parseable::parse(config_parse_options const& options) const {
-        static thread_specific_ptr<vector<shared_ptr<const parseable>>> parse_stack;
-        if (!parse_stack.get()) {
-            // Initialize the stack
-            parse_stack.reset(new vector<shared_ptr<const parseable>>());
-        }
+        // the files being parsed on this thread, outermost first; includes are
+        // parsed on the thread that includes them
+        static thread_local vector<shared_ptr<const parseable>> parse_stack;
 
-        auto pstack = parse_stack.get();
-        if (pstack->size() >= MAX_INCLUDE_DEPTH) {
-            string stacktrace = accumulate(pstack->begin(), pstack->end(), string(), [](string s, shared_ptr<const parseable> p) {
+        if (parse_stack.size() >= MAX_INCLUDE_DEPTH) {
+            string stacktrace = accumulate(parse_stack.begin(), parse_stack.end(), string(), [](string s, shared_ptr<const parseable> p) {
                 return s + '\t' + p->to_string() + '\n';
             });
             throw parse_exception(*_initial_origin, "include statements nested more than " + std::to_string(MAX_INCLUDE_DEPTH) + " times, you probably have a cycle in your includes. Trace:\n" + stacktrace);
         }
 
-        pstack->push_back(shared_from_this());
+        parse_stack.push_back(shared_from_this());
         // call after return when exiting scope
         scope_exit scope([&]() {
-            pstack->pop_back();
-            if (pstack->empty()) {
-                parse_stack.reset();
-            }
+            parse_stack.pop_back();
         });
 
         return force_parsed_to_object(parse_value(options));
@@ -213,6 +227,15 @@ namespace hocon {
         return parse_value(options());
     }
 
+    token_iterator parseable::tokens(config_parse_options const& base_options) const {
+        auto options = fixup_options(base_options);
+        shared_origin origin = options.get_origin_description() ?
+                               make_shared<simple_config_origin>(*options.get_origin_description()) :
+                               _initial_origin;
+        config_syntax syntax = content_type() != config_syntax::UNSPECIFIED ? content_type() : options.get_syntax();
+        return tokenize(move(origin), reader(options), syntax, options);
+    }
+
     shared_value parseable::parse_value(config_parse_options const& base_options) const {
         auto options = fixup_options(base_options);
 
@@ -226,6 +249,8 @@ namespace hocon {
     shared_value parseable::parse_value(shared_origin origin, config_parse_options const& final_options) const {
         try {
             return raw_parse_value(origin, final_options);
+        } catch (const budget_exceeded_exception&) {
+            throw;
         } catch (const runtime_error& e) {
             if (final_options.get_allow_missing()) {
                 return make_shared<simple_config_object>(
@@ -253,10 +278,33 @@ namespace hocon {
     }
 
     shared_value parseable::raw_parse_value(unique_ptr<istream> stream, shared_origin origin,
-                                            config_parse_options const& options) const {
+                                            config_parse_options const& base_options) const {
         // config_syntax::PROPERTIES handling not needed because we don't plan to support it.
-        token_iterator tokens(origin, move(stream), options.get_syntax());
-        auto document = config_document_parser::parse(move(tokens), origin, options);
+        // parse() without options still honors the ones this was made with
+        auto options = base_options;
+        if (_initial_options.get_lazy()) {
+            options = options.set_lazy(true);
+        }
+        if (options.get_parse_threads() == 1) {
+            options = options.set_parse_threads(_initial_options.get_parse_threads());
+        }
+        if (!options.get_budget()) {
+            options = options.set_budget(_initial_options.get_budget());
+        }
+
+        if (auto budget = options.get_budget()) {
+            // limits are checked as the document is parsed, so it's parsed up front
+            options = options.set_lazy(false);
+            stream = read_within(move(stream), *budget);
+        }
+        if (options.get_lazy()) {
+            auto text = make_shared<const string>(istreambuf_iterator<char>(*stream), istreambuf_iterator<char>());
+            if (auto value = lazy_parser::parse(text, origin, options, _include_context, shared_from_this())) {
+                return value;
+            }
+            stream.reset(new istringstream(*text));
+        }
+        auto document = config_document_parser::parse(tokenize(origin, move(stream), options.get_syntax(), options), origin, options);
         return config_parser::parse(document, origin, options, _include_context);
     }
 
@@ -279,6 +327,8 @@ namespace hocon {
                                                                config_parse_options const& final_options) const {
         try {
             return raw_parse_document(origin, final_options);
+        } catch (const budget_exceeded_exception&) {
+            throw;
         } catch (const runtime_error& e) {
             if (final_options.get_allow_missing()) {
                 shared_node_list children;
@@ -310,7 +360,10 @@ namespace hocon {
     std::shared_ptr<config_document> parseable::raw_parse_document(std::unique_ptr<std::istream> stream,
                                                                    shared_origin origin,
                                                                    config_parse_options const& options) const {
-        auto tokens = token_iterator(origin, move(stream), options.get_syntax());
+        if (auto budget = options.get_budget()) {
+            stream = read_within(move(stream), *budget);
+        }
+        auto tokens = tokenize(origin, move(stream), options.get_syntax(), options);
         return make_shared<simple_config_document>(config_document_parser::parse(move(tokens), origin, options), options);
     }
 
@@ -318,6 +371,40 @@ namespace hocon {
         return reader();
     }
 
+    /** An istream over memory it doesn't own, keeping whatever owns it alive. */
+    class source_stream : public istream {
+    public:
+        source_stream(shared_ptr<const void> owner, array_view<char> source) :
+            istream(&_buffer), _owner(std::move(owner)), _buffer(source) { }
+
+    private:
+        class buffer : public streambuf {
+        public:
+            buffer(array_view<char> source) {
+                auto begin = const_cast<char*>(source.begin());
+                setg(begin, begin, begin + source.size);
+            }
+
+        protected:
+            pos_type seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which) override {
+                off_type base = dir == ios_base::beg ? 0 : (dir == ios_base::cur ? gptr() - eback() : egptr() - eback());
+                off_type pos = base + off;
+                if (!(which & ios_base::in) || pos < 0 || pos > egptr() - eback()) {
+                    return pos_type(off_type(-1));
+                }
+                setg(eback(), eback() + pos, egptr());
+                return pos_type(pos);
+            }
+
+            pos_type seekpos(pos_type pos, ios_base::openmode which) override {
+                return seekoff(off_type(pos), ios_base::beg, which);
+            }
+        };
+
+        shared_ptr<const void> _owner;
+        buffer _buffer;
+    };
+
     /** Parseable file */
     parseable_file::parseable_file(std::string input_file_path, config_parse_options options) :
         _input(move(input_file_path)) {
@@ -328,10 +415,15 @@ namespace hocon {
     }
 
     unique_ptr<istream> parseable_file::reader() const {
+        if (auto provider = options().get_source_provider()) {
+            config_source source;
+            if (!provider->open(_input, source)) throw runtime_error("not found");
+            return decompressing_stream(unique_ptr<istream>(new source_stream(move(source.owner), source.bytes)), _input);
+        }
         std::ifstream *is = new std::ifstream();
-        is->open(_input.c_str());
+        is->open(_input.c_str(), ios::binary);
         if (!is->is_open()) throw runtime_error("not found");
-        return unique_ptr<istream>(is);
+        return decompressing_stream(unique_ptr<istream>(is), _input);
     }
 
     shared_origin parseable_file::create_origin() const {
@@ -339,7 +431,7 @@ namespace hocon {
     }
 
     config_syntax parseable_file::guess_syntax() const {
-        return syntax_from_extension(_input);
+        return syntax_from_extension(strip_compression_extension(_input));
     }
 
     /** Parseable string */
@@ -355,6 +447,44 @@ namespace hocon {
         return make_shared<simple_config_origin>("string");
     }
 
+    /** Parseable bundle entry */
+
+    parseable_bundle_entry::parseable_bundle_entry(shared_ptr<const config_bundle> bundle, std::string path,
+                                                   config_parse_options options) :
+            _bundle(move(bundle)), _path(move(path)) {
+        post_construct(options);
+        string dir, name;
+        separate_filepath(_path, &dir, &name);
+        set_cur_dir(dir);
+    }
+
+    unique_ptr<istream> parseable_bundle_entry::reader() const {
+        if (!_bundle->contains(_path)) throw runtime_error("not found");
+        return decompressing_stream(unique_ptr<istream>(new source_stream(_bundle, _bundle->source(_path))), _path);
+    }
+
+    shared_origin parseable_bundle_entry::create_origin() const {
+        return make_shared<simple_config_origin>("file: " + _path + " in bundle " + _bundle->bundle_path());
+    }
+
+    config_syntax parseable_bundle_entry::guess_syntax() const {
+        return syntax_from_extension(strip_compression_extension(_path));
+    }
+
+    shared_ptr<config_parseable> parseable_bundle_entry::relative_to(string file_name) const {
+        if (file_name.empty() || '/' == file_name[0]) {
+            return parseable::relative_to(move(file_name));
+        }
+        auto options = simple_includer::clear_for_include(this->options());
+        auto path = config_bundle::normalize_path(get_cur_dir() + file_name);
+        if (_bundle->contains(path)) {
+            return make_shared<parseable_bundle_entry>(_bundle, move(path), move(options));
+        }
+        string bundle_dir, bundle_name;
+        separate_filepath(_bundle->bundle_path(), &bundle_dir, &bundle_name);
+        return parseable::new_file(bundle_dir + get_cur_dir() + file_name, move(options));
+    }
+
     /** Parseable resources */
     parseable_resources::parseable_resources(std::string resource, config_parse_options options) :
             _resource(move(resource)) {
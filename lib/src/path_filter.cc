@@ -0,0 +1,128 @@
+#include <internal/path_filter.hpp>
+#include <hocon/config_object.hpp>
+
+using namespace std;
+
+namespace hocon {
+
+    // bits set per path, and bits of filter per path; about a 1% false positive rate
+    static const int probes = 6;
+    static const size_t bits_per_path = 10;
+
+    static uint64_t hash_path(string const& path) {
+        // FNV-1a, then a finalizer so every bit depends on every byte
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : path) {
+            h = (h ^ c) * 0x100000001b3ULL;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // a second hash, independent of which block the first one picks
+    static uint64_t rehash(uint64_t h) {
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    path_filter::path_filter(size_t paths) :
+        _blocks(max<size_t>(1, (paths * bits_per_path + 511) / 512), block {}) { }
+
+    shared_ptr<const path_filter> path_filter::build(shared_object const& root) {
+        vector<string> paths;
+        vector<pair<shared_object, string>> pending { { root, "" } };
+        while (!pending.empty()) {
+            auto object = move(pending.back().first);
+            auto prefix = move(pending.back().second);
+            pending.pop_back();
+            for (auto& entry : *object) {
+                // paths through other keys are never looked up in the filter
+                if (!is_plain_key(entry.first)) {
+                    continue;
+                }
+                auto path = prefix.empty() ? entry.first : prefix + "." + entry.first;
+                if (auto child = dynamic_pointer_cast<const config_object>(entry.second)) {
+                    pending.emplace_back(move(child), path);
+                }
+                paths.push_back(move(path));
+            }
+        }
+
+        shared_ptr<path_filter> filter(new path_filter(paths.size()));
+        for (auto& path : paths) {
+            filter->add(path);
+        }
+        return filter;
+    }
+
+    void path_filter::add(string const& path) {
+        uint64_t h = hash_path(path);
+        auto& b = _blocks[h % _blocks.size()];
+        uint64_t bits = rehash(h);
+        // each probe takes 9 bits, picking one of the block's 512 bits
+        for (int i = 0; i < probes; ++i) {
+            unsigned bit = (bits >> (i * 9)) & 511;
+            b.words[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+    }
+
+    bool path_filter::might_contain(string const& path) const {
+        uint64_t h = hash_path(path);
+        auto& b = _blocks[h % _blocks.size()];
+        uint64_t bits = rehash(h);
+        for (int i = 0; i < probes; ++i) {
+            unsigned bit = (bits >> (i * 9)) & 511;
+            if (!(b.words[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool is_word_start(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    static bool is_word_char(char c) {
+        return is_word_start(c) || (c >= '0' && c <= '9') || c == '-';
+    }
+
+    bool path_filter::is_plain_key(string const& key) {
+        if (key.empty() || !is_word_start(key[0])) {
+            return false;
+        }
+        for (char c : key) {
+            if (!is_word_char(c)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool path_filter::is_plain_expression(string const& path_expression) {
+        bool key_start = true;
+        for (char c : path_expression) {
+            if (c == '.') {
+                if (key_start) {
+                    return false;
+                }
+                key_start = true;
+            } else if (key_start ? !is_word_start(c) : !is_word_char(c)) {
+                return false;
+            } else {
+                key_start = false;
+            }
+        }
+        return !key_start;
+    }
+
+    bool path_filter::definitely_absent(string const& path_expression) const {
+        return is_plain_expression(path_expression) && !might_contain(path_expression);
+    }
+
+}  // namespace hocon
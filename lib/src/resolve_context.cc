@@ -1,5 +1,7 @@
 #include <hocon/config_exception.hpp>
+#include <hocon/config_object.hpp>
 #include <hocon/config_value.hpp>
+#include <hocon/config_resolve_cache.hpp>
 #include <internal/resolve_context.hpp>
 #include <internal/resolve_result.hpp>
 #include <internal/resolve_source.hpp>
@@ -20,7 +22,7 @@ namespace hocon {
         return !_restrict_to_child.empty();
     }
 
-    config_resolve_options resolve_context::options() const
+    config_resolve_options const& resolve_context::options() const
     {
         return _options;
     }
@@ -48,10 +50,14 @@ namespace hocon {
             return make_resolve_result(*this, cached);
         } else {
             if (find(_cycle_markers.begin(), _cycle_markers.end(), original) != _cycle_markers.end()) {
-                throw not_possible_to_resolve_exception("Cycle detected, can't resolve.");
+                // cycle detected, can't resolve
+                return make_not_possible_result(*this);
             }
 
             auto result = original->resolve_substitutions(*this, source);
+            if (!result.possible) {
+                return result;
+            }
             auto& resolved = result.value;
             auto& with_memo = result.context;
 
@@ -109,10 +115,22 @@ namespace hocon {
     }
 
     shared_value resolve_context::resolve(shared_value value, shared_object root, config_resolve_options options) {
+        // only whole roots are cached; subtrees are resolved against their root every time
+        if (options.get_cache() && value == root) {
+            auto cache = options.get_cache();
+            return cache->find_or_resolve(value, options, [&]() {
+                return resolve(value, root, options.set_cache(nullptr));
+            });
+        }
+
         resolve_source source { root };
         resolve_context context { options, path(), vector<shared_value> {}};
 
-        return context.resolve(value, source).value;
+        auto result = context.resolve(value, source);
+        if (!result.possible) {
+            throw not_possible_to_resolve_exception("Cycle detected, can't resolve.");
+        }
+        return result.value;
     }
 
     resolve_context resolve_context::memoize(const resolve_context::memo_key& key, const shared_value& value) const {
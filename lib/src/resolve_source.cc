@@ -87,11 +87,18 @@ namespace hocon {
                                                                   int prefix_length) const {
         auto result = find_in_object(_root, move(context), subst->get_path());
 
+        if (!result.result.possible) {
+            return result;
+        }
+
         if (!result.result.value) {
             auto unprefixed = subst->get_path().sub_path(prefix_length);
 
             if (prefix_length > 0) {
                 result = find_in_object(_root, result.result.context, unprefixed);
+                if (!result.result.possible) {
+                    return result;
+                }
             }
 
             if (!result.result.value && result.result.context.options().get_use_system_environment()) {
@@ -106,6 +113,9 @@ namespace hocon {
                                                                     path the_path) {
         auto restriction = context.restrict_to_child();
         auto partially_resolved = context.restrict(the_path).resolve(dynamic_pointer_cast<const config_value>(obj), {obj});
+        if (!partially_resolved.possible) {
+            return {move(partially_resolved), {}};
+        }
         auto new_context = partially_resolved.context.restrict(restriction);
 
         if (auto value = dynamic_pointer_cast<const config_object>(partially_resolved.value)) {
@@ -231,6 +231,14 @@ namespace hocon {
     }
 
 
+    bool simple_config_origin::is_line_of(simple_config_origin const& other) const {
+        return (_line_number == _end_line_number) &&
+                (other._description == _description) &&
+                (other._origin_type == _origin_type) &&
+                (other._resource_or_null == _resource_or_null) &&
+                (other._comments_or_null == _comments_or_null);
+    }
+
     bool simple_config_origin::operator==(const simple_config_origin &other) const {
         return (other._description == _description) &&
                 (other._line_number == _line_number) &&
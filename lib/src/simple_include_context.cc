@@ -15,4 +15,8 @@ namespace hocon {
         return simple_includer::clear_for_include(_parseable.options());
     }
 
+    std::string simple_include_context::get_cur_dir() const {
+        return _parseable.get_cur_dir();
+    }
+
 }  // namespace hocon
@@ -3,6 +3,7 @@
 #include <internal/simple_include_context.hpp>
 #include <internal/values/simple_config_object.hpp>
 #include <internal/parseable.hpp>
+#include <internal/decompressing_stream.hpp>
 #include <hocon/config_exception.hpp>
 
 using namespace std;
@@ -84,7 +85,8 @@ namespace hocon {
     shared_object simple_includer::from_basename(std::shared_ptr<name_source> source, std::string name,
                                                  config_parse_options options) {
         shared_object obj;
-        if (ends_with(name, ".conf") || ends_with(name, ".json")) {
+        auto uncompressed_name = strip_compression_extension(name);
+        if (ends_with(uncompressed_name, ".conf") || ends_with(uncompressed_name, ".json")) {
             shared_parseable p(nullptr);
             if (source->context_initialized()) {
                 p = source->name_to_parseable(name, options);
@@ -107,6 +109,8 @@ namespace hocon {
                 try {
                     auto parse_options = conf_handle->options().set_allow_missing(false).set_syntax(config_syntax::CONF);
                     obj = conf_handle->parse(parse_options);
+                } catch (budget_exceeded_exception&) {
+                    throw;
                 } catch (config_exception& ex) {
                     fails.push_back(ex);
                 }
@@ -119,6 +123,8 @@ namespace hocon {
                     obj = dynamic_pointer_cast<const config_object>(obj->with_fallback(parsed));
 
                     got_something = true;
+                } catch (budget_exceeded_exception&) {
+                    throw;
                 } catch (config_exception& ex) {
                     fails.push_back(ex);
                 }
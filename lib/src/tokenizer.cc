@@ -6,7 +6,10 @@
 #include <internal/values/config_long.hpp>
 #include <internal/values/config_string.hpp>
 
+#include <algorithm>
+#include <exception>
 #include <sstream>
+#include <thread>
 
 using namespace std;
 
@@ -76,9 +79,10 @@ namespace hocon {
     /**
      * Token Iterator
      */
-    token_iterator::token_iterator(shared_origin origin, unique_ptr<std::istream> input, bool allow_comments) :
+    token_iterator::token_iterator(shared_origin origin, unique_ptr<std::istream> input, bool allow_comments,
+                                   int first_line_number) :
             _origin(move(origin)), _input(move(input)), _allow_comments(allow_comments),
-            _line_number(1), _line_origin(_origin->with_line_number(1))
+            _line_number(first_line_number), _line_origin(_origin->with_line_number(first_line_number))
     {
         _tokens.push(tokens::start_token());
     }
@@ -86,6 +90,155 @@ namespace hocon {
     token_iterator::token_iterator(shared_origin origin, unique_ptr<std::istream> input, config_syntax flavor) :
         token_iterator(move(origin), move(input), flavor != config_syntax::JSON) {}
 
+    token_iterator::token_iterator(shared_origin origin, bool allow_comments, token_list tokens) :
+            _origin(move(origin)), _input(new istringstream()), _allow_comments(allow_comments),
+            _line_number(1), _line_origin(_origin->with_line_number(1)),
+            _tokens(deque<shared_token>(make_move_iterator(tokens.begin()), make_move_iterator(tokens.end())))
+    { }
+
+    /**
+     * Finds where to split input so each chunk can be tokenized on its own: just
+     * after a newline that isn't inside a string, comment or substitution. At
+     * those points a token_iterator has nothing saved from the previous line, so
+     * a new one started on the next line produces the same tokens. This follows
+     * the tokenizer's rules for quotes, comments and ${} and nothing else.
+     * Returns the offset each chunk starts at.
+     */
+    static vector<size_t> find_chunk_starts(string const& input, bool allow_comments, size_t chunk_count) {
+        enum class state { normal, quoted, triple_quoted, comment };
+
+        vector<size_t> starts { 0 };
+        size_t chunk_size = input.size() / chunk_count + 1;
+        size_t next_split = chunk_size;
+        size_t size = input.size();
+        state s = state::normal;
+        int substitution_depth = 0;
+        int quotes = 0;
+
+        auto at = [&](size_t i) { return i < size ? input[i] : '\0'; };
+
+        for (size_t i = 0; i < size;) {
+            char c = input[i];
+            switch (s) {
+                case state::normal:
+                    if (c == '\n') {
+                        ++i;
+                        if (substitution_depth == 0 && i >= next_split && i < size) {
+                            starts.push_back(i);
+                            next_split = i + chunk_size;
+                        }
+                    } else if (c == '"') {
+                        if (at(i + 1) == '"' && at(i + 2) == '"') {
+                            s = state::triple_quoted;
+                            quotes = 0;
+                            i += 3;
+                        } else {
+                            s = state::quoted;
+                            ++i;
+                        }
+                    } else if (allow_comments && (c == '#' || (c == '/' && at(i + 1) == '/'))) {
+                        s = state::comment;
+                        ++i;
+                    } else if (c == '$' && at(i + 1) == '{') {
+                        ++substitution_depth;
+                        i += 2;
+                    } else {
+                        if (c == '}' && substitution_depth > 0) {
+                            --substitution_depth;
+                        }
+                        ++i;
+                    }
+                    break;
+                case state::quoted:
+                    if (c == '\\') {
+                        // the tokenizer takes four characters after \u whatever they are
+                        i += at(i + 1) == 'u' ? 6 : 2;
+                    } else {
+                        if (c == '"') {
+                            s = state::normal;
+                        }
+                        ++i;
+                    }
+                    break;
+                case state::triple_quoted:
+                    // three or more quotes end the string at the next character that isn't one
+                    if (c == '"') {
+                        ++quotes;
+                        ++i;
+                    } else if (quotes >= 3) {
+                        s = state::normal;
+                    } else {
+                        quotes = 0;
+                        ++i;
+                    }
+                    break;
+                case state::comment:
+                    if (c == '\n') {
+                        s = state::normal;
+                    } else {
+                        ++i;
+                    }
+                    break;
+            }
+        }
+        return starts;
+    }
+
+    token_iterator token_iterator::tokenize_parallel(shared_origin origin, string input,
+                                                     config_syntax flavor, unsigned threads) {
+        bool allow_comments = flavor != config_syntax::JSON;
+        auto starts = find_chunk_starts(input, allow_comments, max(threads, 1u));
+        if (starts.size() < 2) {
+            return token_iterator(move(origin), unique_ptr<istream>(new istringstream(move(input))), allow_comments);
+        }
+
+        // a chunk's first line is one more than the number of newlines before it
+        vector<int> first_lines { 1 };
+        for (size_t i = 1; i < starts.size(); ++i) {
+            first_lines.push_back(first_lines.back() +
+                                  static_cast<int>(std::count(input.begin() + starts[i - 1], input.begin() + starts[i], '\n')));
+        }
+
+        vector<token_list> chunks(starts.size());
+        vector<exception_ptr> errors(starts.size());
+        auto tokenize_chunk = [&](size_t i) {
+            try {
+                size_t end = i + 1 < starts.size() ? starts[i + 1] : input.size();
+                unique_ptr<istream> chunk(new istringstream(input.substr(starts[i], end - starts[i])));
+                token_iterator tokens(origin, move(chunk), allow_comments, first_lines[i]);
+                while (tokens.has_next()) {
+                    chunks[i].push_back(tokens.next());
+                }
+            } catch (...) {
+                errors[i] = current_exception();
+            }
+        };
+
+        vector<thread> workers;
+        for (size_t i = 1; i < starts.size(); ++i) {
+            workers.emplace_back(tokenize_chunk, i);
+        }
+        tokenize_chunk(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (auto& error : errors) {
+            if (error) {
+                return token_iterator(move(origin), unique_ptr<istream>(new istringstream(move(input))), allow_comments);
+            }
+        }
+
+        // every chunk starts with START and ends with END; keep only the outer two
+        token_list stitched;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            auto first = chunks[i].begin() + (i == 0 ? 0 : 1);
+            auto last = chunks[i].end() - (i + 1 == chunks.size() ? 0 : 1);
+            stitched.insert(stitched.end(), make_move_iterator(first), make_move_iterator(last));
+        }
+        return token_iterator(move(origin), allow_comments, move(stitched));
+    }
+
     bool token_iterator::start_of_comment(char c) {
         if (!*_input) {
             return false;
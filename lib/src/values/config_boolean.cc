@@ -1,4 +1,5 @@
 #include <internal/values/config_boolean.hpp>
+#include <hocon/config_value_visitor.hpp>
 
 using namespace std;
 
@@ -23,6 +24,10 @@ namespace hocon {
         return _value;
     }
 
+    void config_boolean::accept(config_value_visitor& visitor) const {
+        visitor.boolean_value(_value);
+    }
+
     shared_value config_boolean::new_copy(shared_origin origin) const {
         return make_shared<config_boolean>(move(origin), _value);
     }
@@ -10,6 +10,7 @@
 #include <internal/resolve_result.hpp>
 #include <internal/resolve_source.hpp>
 #include <internal/resolve_context.hpp>
+#include <hocon/config_budget.hpp>
 
 using namespace std;
 
@@ -79,6 +80,9 @@ namespace hocon {
             // so unrestrict the context, then put restriction back afterward
             auto restriction = new_context.restrict_to_child();
             resolve_result<shared_value> result {new_context.unrestricted().resolve(p, source)};
+            if (!result.possible) {
+                return result;
+            }
             auto r = result.value;
             new_context = result.context.restrict(restriction);
 
@@ -91,6 +95,15 @@ namespace hocon {
 
         // now need to concat everything
         vector<shared_value> joined { consolidate(resolved) };
+        if (auto const& budget = context.options().get_budget()) {
+            for (auto const& v : joined) {
+                if (auto str = dynamic_pointer_cast<const config_string>(v)) {
+                    budget->spend_output(str->transform_to_string().size());
+                } else if (auto list = dynamic_pointer_cast<const simple_config_list>(v)) {
+                    budget->spend_output(list->size());
+                }
+            }
+        }
         // if unresolved is allowed we can just become another
         // ConfigConcatenation
         if (joined.size() > 1 && context.options().get_allow_unresolved()) {
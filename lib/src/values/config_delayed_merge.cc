@@ -95,6 +95,9 @@ namespace hocon {
             // TODO tracing
 
             auto result = new_context.resolve(end, source_for_end);
+            if (!result.possible) {
+                return result;
+            }
             auto resolved_end = result.value;
             new_context = result.context;
 
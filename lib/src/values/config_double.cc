@@ -1,4 +1,5 @@
 #include <internal/values/config_double.hpp>
+#include <hocon/config_value_visitor.hpp>
 
 using namespace std;
 
@@ -20,6 +21,10 @@ namespace hocon {
         return _value;
     }
 
+    void config_double::accept(config_value_visitor& visitor) const {
+        visitor.double_value(_value);
+    }
+
     int64_t config_double::long_value() const {
         return static_cast<int64_t>(_value);
     }
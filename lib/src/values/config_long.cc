@@ -1,4 +1,5 @@
 #include <internal/values/config_long.hpp>
+#include <hocon/config_value_visitor.hpp>
 
 using namespace std;
 
@@ -20,6 +21,10 @@ namespace hocon {
         return _value;
     }
 
+    void config_long::accept(config_value_visitor& visitor) const {
+        visitor.long_value(_value);
+    }
+
     int64_t config_long::long_value() const {
         return _value;
     }
@@ -1,4 +1,5 @@
 #include <internal/values/config_null.hpp>
+#include <hocon/config_value_visitor.hpp>
 
 using namespace std;
 
@@ -23,6 +24,10 @@ namespace hocon {
         return nullptr;
     }
 
+    void config_null::accept(config_value_visitor& visitor) const {
+        visitor.null_value();
+    }
+
     bool config_null::operator==(config_value const& other) const {
         return dynamic_cast<config_null const*>(&other);
     }
@@ -21,15 +21,15 @@ namespace hocon {
             path next = desired_path.remainder();
             shared_value v = self->attempt_peek_with_partial_resolve(*desired_path.first());
 
-            if (next.empty()) {
-                return v;
-            } else {
-                if (auto object = dynamic_pointer_cast<const config_object>(v)) {
-                    return peek_path(object.get(), next);
-                } else {
+            while (!next.empty()) {
+                auto object = dynamic_pointer_cast<const config_object>(v);
+                if (!object) {
                     return nullptr;
                 }
+                v = object->attempt_peek_with_partial_resolve(*next.first());
+                next = next.remainder();
             }
+            return v;
         } catch (config_exception& ex) {
             throw config_exception(desired_path.render() + " has not been resolved, you need to call config::resolve()");
         }
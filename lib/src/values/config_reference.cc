@@ -4,6 +4,7 @@
 #include <internal/resolve_source.hpp>
 #include <internal/container.hpp>
 #include <internal/substitution_expression.hpp>
+#include <hocon/config_budget.hpp>
 
 using namespace std;
 
@@ -41,22 +42,31 @@ namespace hocon {
     }
 
     resolve_result<shared_value> config_reference::resolve_substitutions(resolve_context const &context, resolve_source const &source) const {
+        if (auto const& budget = context.options().get_budget()) {
+            budget->spend_expansion();
+        }
         resolve_context new_context = context.add_cycle_marker(shared_from_this());
         shared_value v;
 
-        try {
-            auto result_with_path = source.lookup_subst(move(new_context), _expr, _prefix_length);
+        auto result_with_path = source.lookup_subst(new_context, _expr, _prefix_length);
+        bool possible = result_with_path.result.possible;
+
+        if (possible) {
             new_context = result_with_path.result.context;
 
             if (result_with_path.result.value) {
                 resolve_source recursive_resolve_source {dynamic_pointer_cast<const config_object>(result_with_path.path_from_root.back()), result_with_path.path_from_root};
                 auto result = new_context.resolve(result_with_path.result.value, recursive_resolve_source);
-                v = result.value;
-                new_context = result.context;
-            } else {
-                v = nullptr;
+                possible = result.possible;
+                if (possible) {
+                    v = result.value;
+                    new_context = result.context;
+                }
             }
-        } catch (not_possible_to_resolve_exception& ex) {
+        }
+
+        if (!possible) {
+            // we're part of a cycle of substitutions; an optional reference just drops out
             if (_expr->optional()) {
                 v = nullptr;
             } else {
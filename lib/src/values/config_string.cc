@@ -1,11 +1,12 @@
 #include <internal/values/config_string.hpp>
+#include <hocon/config_value_visitor.hpp>
 
 using namespace std;
 
 namespace hocon {
 
-    config_string::config_string(shared_origin origin, string text, config_string_type quoted) :
-        config_value(move(origin)), _text(move(text)), _quoted(quoted) { }
+    config_string::config_string(shared_origin origin, string text, config_string_type quoted, bool memoize) :
+        config_value(move(origin)), _text(move(text)), _quoted(quoted), _memoize(memoize) { }
 
     config_value::type config_string::value_type() const {
         return config_value::type::STRING;
@@ -23,6 +24,19 @@ namespace hocon {
         return _text;
     }
 
+    void config_string::accept(config_value_visitor& visitor) const {
+        visitor.string_value(_text);
+    }
+
+    config_string::memo<shared_value> const* config_string::coercion_memo(config_value::type requested) const {
+        switch (requested) {
+            case config_value::type::NUMBER: return &_number;
+            case config_value::type::BOOLEAN: return &_boolean;
+            case config_value::type::CONFIG_NULL: return &_null;
+            default: return nullptr;
+        }
+    }
+
     bool config_string::was_quoted() const {
         return _quoted == config_string_type::QUOTED;
     }
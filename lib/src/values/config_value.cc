@@ -1,4 +1,5 @@
 #include <hocon/config_value.hpp>
+#include <hocon/config_value_visitor.hpp>
 #include <internal/config_util.hpp>
 #include <hocon/config_object.hpp>
 #include <hocon/config_exception.hpp>
@@ -109,6 +110,10 @@ namespace hocon {
         return at_path(move(origin), path::new_path(path_expression));
     }
 
+    void config_value::accept(config_value_visitor&) const {
+        throw not_resolved_exception("Can't visit an unresolved " + string(value_type_name()) + " value.");
+    }
+
     shared_value config_value::with_origin(shared_origin origin) const {
         if (_origin == origin) {
             return shared_from_this();
@@ -0,0 +1,380 @@
+#include <internal/values/packed_elements.hpp>
+#include <internal/values/config_boolean.hpp>
+#include <internal/values/config_double.hpp>
+#include <internal/values/config_int.hpp>
+#include <internal/values/config_long.hpp>
+#include <internal/values/config_null.hpp>
+#include <internal/values/config_string.hpp>
+#include <internal/values/simple_config_object.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <typeinfo>
+
+using namespace std;
+
+namespace hocon {
+
+    // doubles in this range can be checked for being whole with a cast to int64_t
+    static const double max_whole_double = 9.2e18;
+    // longs in this range convert to double and back exactly
+    static const int64_t max_exact_long = int64_t(1) << 53;
+
+    bool packed_column::is_whole(double d) {
+        return d > -max_whole_double && d < max_whole_double && static_cast<int64_t>(d) == d;
+    }
+
+    packed_column::kind packed_column::kind_of(shared_value const& v) {
+        auto& value = *v;
+        auto& type = typeid(value);
+        if (type == typeid(config_int) || type == typeid(config_long)) {
+            return kind::LONG;
+        } else if (type == typeid(config_double)) {
+            return kind::DOUBLE;
+        } else if (type == typeid(config_boolean)) {
+            return kind::BOOLEAN;
+        } else if (type == typeid(config_string)) {
+            return kind::STRING;
+        } else if (type == typeid(config_null)) {
+            return kind::CONFIG_NULL;
+        } else {
+            return kind::BOXED;
+        }
+    }
+
+    string packed_column::canonical_text(int64_t value) {
+        return to_string(value);
+    }
+
+    string packed_column::canonical_text(double value) {
+        // shortest %g representation that reads back as the same double
+        char buffer[32];
+        for (int precision = 1; precision <= 17; ++precision) {
+            snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            if (strtod(buffer, nullptr) == value) {
+                break;
+            }
+        }
+        return buffer;
+    }
+
+    unique_ptr<packed_column> packed_column::pack(vector<shared_value> const& values,
+                                                  shared_origin const& origin_template,
+                                                  vector<int> const& default_lines) {
+        size_t size = values.size();
+        auto boxed = [&]() {
+            unique_ptr<packed_column> column(new packed_column(kind::BOXED, size));
+            column->_boxed = values;
+            return column;
+        };
+
+        auto tmpl = dynamic_pointer_cast<const simple_config_origin>(origin_template);
+        if (!tmpl || values.empty()) {
+            return boxed();
+        }
+
+        kind k = kind_of(values.front());
+        for (auto& v : values) {
+            kind vk = kind_of(v);
+            if (vk == k) {
+                continue;
+            } else if ((vk == kind::LONG || vk == kind::DOUBLE) && (k == kind::LONG || k == kind::DOUBLE)) {
+                k = kind::DOUBLE;
+            } else {
+                return boxed();
+            }
+        }
+        if (k == kind::BOXED) {
+            return boxed();
+        }
+
+        unique_ptr<packed_column> column(new packed_column(k, size));
+        switch (k) {
+            case kind::LONG: column->_longs.reserve(size); break;
+            case kind::DOUBLE: column->_doubles.reserve(size); break;
+            case kind::STRING:
+                column->_strings.reserve(size);
+                // quoted-ness goes in the bits
+                [[fallthrough]];
+            case kind::BOOLEAN: column->_bits.assign((size + 63) / 64, 0); break;
+            default: break;
+        }
+
+        bool all_default_lines = true;
+        vector<int> lines;
+        lines.reserve(size);
+
+        for (size_t i = 0; i < size; ++i) {
+            auto& v = values[i];
+            auto origin = dynamic_pointer_cast<const simple_config_origin>(v->origin());
+            if (!origin || !origin->is_line_of(*tmpl)) {
+                return boxed();
+            }
+            lines.push_back(origin->line_number());
+            if (origin->line_number() != default_lines[i]) {
+                all_default_lines = false;
+            }
+
+            switch (k) {
+                case kind::LONG: {
+                    auto n = dynamic_pointer_cast<const config_number>(v);
+                    int64_t l = n->long_value();
+                    // ints and longs are told apart by range when boxing
+                    bool fits_int = l >= numeric_limits<int>::min() && l <= numeric_limits<int>::max();
+                    if (fits_int != (typeid(*n) == typeid(config_int))) {
+                        return boxed();
+                    }
+                    column->_longs.push_back(l);
+                    auto text = n->transform_to_string();
+                    if (text != canonical_text(l)) {
+                        column->_texts.emplace(i, move(text));
+                    }
+                    break;
+                }
+                case kind::DOUBLE: {
+                    auto n = dynamic_pointer_cast<const config_number>(v);
+                    double d;
+                    if (typeid(*n) == typeid(config_double)) {
+                        d = n->double_value();
+                        if (!isfinite(d) || is_whole(d)) {
+                            return boxed();
+                        }
+                    } else {
+                        int64_t l = n->long_value();
+                        if (l <= -max_exact_long || l >= max_exact_long) {
+                            return boxed();
+                        }
+                        d = static_cast<double>(l);
+                    }
+                    column->_doubles.push_back(d);
+                    auto text = n->transform_to_string();
+                    auto canonical = is_whole(d) ? canonical_text(static_cast<int64_t>(d)) : canonical_text(d);
+                    if (text != canonical) {
+                        column->_texts.emplace(i, move(text));
+                    }
+                    break;
+                }
+                case kind::BOOLEAN:
+                    if (dynamic_pointer_cast<const config_boolean>(v)->bool_value()) {
+                        column->_bits[i / 64] |= uint64_t(1) << (i % 64);
+                    }
+                    break;
+                case kind::STRING: {
+                    auto str = dynamic_pointer_cast<const config_string>(v);
+                    column->_strings.push_back(str->transform_to_string());
+                    if (str->was_quoted()) {
+                        column->_bits[i / 64] |= uint64_t(1) << (i % 64);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        if (!all_default_lines) {
+            column->_lines = move(lines);
+        }
+        return column;
+    }
+
+    shared_value packed_column::box(size_t index, shared_origin const& origin_template,
+                                    shared_origin const& default_origin) const {
+        if (_kind == kind::BOXED) {
+            return _boxed.at(index);
+        }
+        if (index >= _size) {
+            throw out_of_range("packed_column::box: index out of range");
+        }
+
+        auto origin = _lines.empty() ? default_origin : origin_template->with_line_number(_lines[index]);
+        auto text = [&](string canonical) {
+            auto iter = _texts.find(index);
+            return iter == _texts.end() ? move(canonical) : iter->second;
+        };
+
+        switch (_kind) {
+            case kind::LONG: {
+                int64_t l = _longs[index];
+                return config_number::new_number(move(origin), l, text(canonical_text(l)));
+            }
+            case kind::DOUBLE: {
+                double d = _doubles[index];
+                if (is_whole(d)) {
+                    auto l = static_cast<int64_t>(d);
+                    return config_number::new_number(move(origin), l, text(canonical_text(l)));
+                }
+                return make_shared<config_double>(move(origin), d, text(canonical_text(d)));
+            }
+            case kind::BOOLEAN:
+                return make_shared<config_boolean>(move(origin), boolean_at(index));
+            case kind::STRING:
+                return make_shared<config_string>(move(origin), _strings[index],
+                                                  boolean_at(index) ? config_string_type::QUOTED : config_string_type::UNQUOTED);
+            case kind::CONFIG_NULL:
+                return make_shared<config_null>(move(origin));
+            default:
+                throw bug_or_broken_exception("packed_column::box: unexpected kind");
+        }
+    }
+
+    size_t packed_column::memory_usage() const {
+        size_t bytes = sizeof(*this);
+        bytes += _longs.capacity() * sizeof(int64_t);
+        bytes += _doubles.capacity() * sizeof(double);
+        bytes += _bits.capacity() * sizeof(uint64_t);
+        bytes += _lines.capacity() * sizeof(int);
+        bytes += _boxed.capacity() * sizeof(shared_value);
+        for (auto& s : _strings) {
+            bytes += sizeof(string) + (s.capacity() > 15 ? s.capacity() + 1 : 0);
+        }
+        for (auto& t : _texts) {
+            bytes += sizeof(t) + sizeof(void*) * 2 + t.second.capacity();
+        }
+        return bytes;
+    }
+
+    static size_t hash_combine(size_t seed, size_t h) {
+        return seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    size_t packed_column::hash() const {
+        size_t h = hash_combine(static_cast<size_t>(_kind), _size);
+        switch (_kind) {
+            case kind::LONG:
+                for (auto l : _longs) {
+                    h = hash_combine(h, std::hash<int64_t>()(l));
+                }
+                break;
+            case kind::DOUBLE:
+                for (auto d : _doubles) {
+                    h = hash_combine(h, std::hash<double>()(d));
+                }
+                break;
+            case kind::BOOLEAN:
+                for (auto bits : _bits) {
+                    h = hash_combine(h, std::hash<uint64_t>()(bits));
+                }
+                break;
+            case kind::STRING:
+                for (auto& str : _strings) {
+                    h = hash_combine(h, std::hash<string>()(str));
+                }
+                break;
+            default:
+                // nulls are all alike, and boxed values are left to comparison
+                break;
+        }
+        return h;
+    }
+
+    shared_ptr<const packed_scalars> packed_scalars::pack(shared_origin const& list_origin,
+                                                          vector<shared_value> const& values) {
+        auto column = packed_column::pack(values, list_origin,
+                                          vector<int>(values.size(), list_origin->line_number()));
+        switch (column->get_kind()) {
+            case packed_column::kind::LONG:
+            case packed_column::kind::DOUBLE:
+            case packed_column::kind::BOOLEAN:
+                return shared_ptr<const packed_scalars>(new packed_scalars(list_origin, move(column)));
+            default:
+                return nullptr;
+        }
+    }
+
+    shared_value packed_scalars::get(size_t index) const {
+        return _column->box(index, _origin_template, _origin_template);
+    }
+
+    size_t packed_scalars::memory_usage() const {
+        return sizeof(*this) + _column->memory_usage();
+    }
+
+    size_t packed_scalars::hash() const {
+        return _column->hash();
+    }
+
+    shared_ptr<const packed_objects> packed_objects::pack(shared_origin const& list_origin,
+                                                          vector<shared_value> const& values) {
+        auto tmpl = dynamic_pointer_cast<const simple_config_origin>(list_origin);
+        if (!tmpl || values.empty()) {
+            return nullptr;
+        }
+
+        vector<shared_ptr<const simple_config_object>> rows;
+        rows.reserve(values.size());
+        for (auto& v : values) {
+            auto& value = *v;
+            if (typeid(value) != typeid(simple_config_object)) {
+                return nullptr;
+            }
+            auto row = static_pointer_cast<const simple_config_object>(v);
+            auto origin = dynamic_pointer_cast<const simple_config_origin>(row->origin());
+            if (row->get_resolve_status() != resolve_status::RESOLVED || row->ignores_fallbacks() ||
+                    !origin || !origin->is_line_of(*tmpl)) {
+                return nullptr;
+            }
+            rows.push_back(move(row));
+        }
+
+        shared_ptr<packed_objects> packed(new packed_objects(list_origin));
+        packed->_keys = rows.front()->key_set();
+        sort(packed->_keys.begin(), packed->_keys.end());
+
+        packed->_lines.reserve(rows.size());
+        for (auto& row : rows) {
+            if (row->size() != packed->_keys.size()) {
+                return nullptr;
+            }
+            packed->_lines.push_back(row->origin()->line_number());
+        }
+
+        vector<shared_value> cells(rows.size());
+        for (auto& key : packed->_keys) {
+            for (size_t i = 0; i < rows.size(); ++i) {
+                cells[i] = rows[i]->get(key);
+                if (!cells[i]) {
+                    return nullptr;
+                }
+            }
+            packed->_columns.push_back(packed_column::pack(cells, list_origin, packed->_lines));
+        }
+        return packed;
+    }
+
+    shared_value packed_objects::get(size_t index) const {
+        auto origin = _origin_template->with_line_number(_lines.at(index));
+
+        unordered_map<string, shared_value> fields;
+        fields.reserve(_keys.size());
+        for (size_t k = 0; k < _keys.size(); ++k) {
+            fields.emplace(_keys[k], _columns[k]->box(index, _origin_template, origin));
+        }
+        return make_shared<simple_config_object>(move(origin), move(fields), resolve_status::RESOLVED, false);
+    }
+
+    size_t packed_objects::memory_usage() const {
+        size_t bytes = sizeof(*this) + _lines.capacity() * sizeof(int);
+        for (auto& key : _keys) {
+            bytes += sizeof(string) + key.capacity();
+        }
+        for (auto& column : _columns) {
+            bytes += column->memory_usage();
+        }
+        return bytes;
+    }
+
+    size_t packed_objects::hash() const {
+        size_t h = _lines.size();
+        for (size_t k = 0; k < _keys.size(); ++k) {
+            h = hash_combine(h, std::hash<string>()(_keys[k]));
+            h = hash_combine(h, _columns[k]->hash());
+        }
+        return h;
+    }
+
+}  // namespace hocon
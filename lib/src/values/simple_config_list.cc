@@ -1,4 +1,5 @@
 #include <hocon/config_value.hpp>
+#include <hocon/config_value_visitor.hpp>
 #include <internal/values/simple_config_list.hpp>
 #include <internal/simple_config_origin.hpp>
 #include <hocon/config_exception.hpp>
@@ -19,12 +20,19 @@ namespace hocon {
         shared_value modify_child_may_throw(string const& key, shared_value v) override
         {
             resolve_result<shared_value> result = context.resolve(v, source);
+            if (!result.possible) {
+                not_possible = true;
+                return v;
+            }
             context = result.context;
             return result.value;
         }
 
+        bool stopped() const override { return not_possible; }
+
         resolve_context context;
         resolve_source source;
+        bool not_possible = false;
     };
 
     simple_config_list::simple_config_list(shared_origin origin, std::vector<shared_value> value)
@@ -38,8 +46,83 @@ namespace hocon {
         }
     }
 
+    simple_config_list::simple_config_list(shared_origin origin, shared_ptr<const packed_elements> packed)
+            : config_list(move(origin)), _packed(move(packed)), _resolved(resolve_status::RESOLVED) { }
+
+    // Small lists aren't worth packing; the saving is per element.
+    static const size_t min_packed_size = 16;
+
+    shared_ptr<const simple_config_list> simple_config_list::make_packed(shared_origin origin, vector<shared_value> value)
+    {
+        if (value.size() >= min_packed_size && resolve_status_from_values(value) == resolve_status::RESOLVED) {
+            shared_ptr<const packed_elements> packed;
+            if (value.front()->value_type() == config_value::type::OBJECT) {
+                packed = packed_objects::pack(origin, value);
+            } else {
+                packed = packed_scalars::pack(origin, value);
+            }
+            if (packed) {
+                return make_shared<simple_config_list>(move(origin), move(packed));
+            }
+        }
+        return make_shared<simple_config_list>(move(origin), move(value));
+    }
+
+    size_t simple_config_list::memory_usage() const
+    {
+        if (_packed) {
+            return sizeof(*this) + _packed->memory_usage();
+        }
+        return sizeof(*this) + _value.capacity() * sizeof(shared_value);
+    }
+
+    array_view<int64_t> simple_config_list::packed_longs() const
+    {
+        auto scalars = dynamic_pointer_cast<const packed_scalars>(_packed);
+        if (!scalars || scalars->column().get_kind() != packed_column::kind::LONG) {
+            return {};
+        }
+        auto& longs = scalars->column().longs();
+        return { longs.data(), longs.size() };
+    }
+
+    array_view<double> simple_config_list::packed_doubles() const
+    {
+        auto scalars = dynamic_pointer_cast<const packed_scalars>(_packed);
+        if (!scalars || scalars->column().get_kind() != packed_column::kind::DOUBLE) {
+            return {};
+        }
+        auto& doubles = scalars->column().doubles();
+        return { doubles.data(), doubles.size() };
+    }
+
+    shared_value simple_config_list::get(size_t index) const
+    {
+        if (_packed) {
+            if (index >= _packed->size()) {
+                throw out_of_range("simple_config_list::get: index out of range");
+            }
+            return _packed->get(index);
+        }
+        return _value.at(index);
+    }
+
+    int simple_config_list::index_of(shared_value v) const
+    {
+        for (auto it = begin(), end_it = end(); it != end_it; ++it) {
+            if (*it == v || (_packed && v && **it == *v)) {
+                return static_cast<int>(it - begin());
+            }
+        }
+        return -1;
+    }
+
     shared_value simple_config_list::replace_child(shared_value const& child, shared_value replacement) const
     {
+        if (_packed) {
+            // packed lists are resolved, and their elements are made each time they're read
+            throw bug_or_broken_exception("can't replace a child of a packed list");
+        }
         auto new_list = replace_child_in_list(_value, child, replacement);
         if (new_list.empty()) {
             return nullptr;
@@ -50,6 +133,10 @@ namespace hocon {
 
     bool simple_config_list::has_descendant(shared_value const& descendant) const
     {
+        if (_packed) {
+            // elements that couldn't be packed are handed out as they are, so look through them
+            return has_descendant_in_list(vector<shared_value>(begin(), end()), descendant);
+        }
         return has_descendant_in_list(_value, descendant);
     }
 
@@ -66,6 +153,9 @@ namespace hocon {
             resolve_modifier mod{context, source.push_parent(dynamic_pointer_cast<const container>(shared_from_this()))};
             resolve_status s = resolve_status::RESOLVED;
             auto value = modify_may_throw(mod, context.options().get_allow_unresolved() ? nullptr : &s);
+            if (mod.not_possible) {
+                return make_not_possible_result(mod.context);
+            }
             return resolve_result<shared_value>(mod.context, value);
         }
     }
@@ -91,6 +181,9 @@ namespace hocon {
     {
         // TODO: Copies the list, but the list is immutable so we could share the vector.
         //       Best to deal with in a rewrite that encapsulates shared_ptr and immutability better.
+        if (_packed) {
+            return make_shared<simple_config_list>(move(origin), _packed);
+        }
         return make_shared<simple_config_list>(move(origin), _value);
     }
 
@@ -100,8 +193,11 @@ namespace hocon {
             if (size() != o.size()) {
                 return false;
             }
+            if (_packed && _packed == o._packed) {
+                return true;
+            }
 
-            if (equal(begin(), end(), o.begin(),
+            if (!_packed && !o._packed && equal(begin(), end(), o.begin(),
                       [](shared_value const& a, shared_value const& b) { return a == b; })) {
                 return true;
             }
@@ -115,14 +211,14 @@ namespace hocon {
                                     bool at_root,
                                     config_render_options options) const
     {
-        if (_value.empty()) {
+        if (is_empty()) {
             sb.append("[]");
         } else {
             sb.push_back('[');
             if (options.get_formatted()) {
                 sb.push_back('\n');
             }
-            for (auto &v : _value) {
+            for (auto& v : *this) {
                 if (options.get_origin_comments()) {
                     // Could be done more efficiently with a split_iterator, but those are trickier to use with range-for.
                     vector<string> lines;
@@ -167,12 +263,45 @@ namespace hocon {
 
     unwrapped_value simple_config_list::unwrapped() const {
         vector<unwrapped_value> values;
-        for (auto it = _value.begin(), endIt = _value.end(); it != endIt; ++it) {
+        for (auto it = begin(), endIt = end(); it != endIt; ++it) {
             values.emplace_back((*it)->unwrapped());
         }
         return values;
     }
 
+    void simple_config_list::accept(config_value_visitor& visitor) const {
+        visitor.begin_list(size());
+        auto scalars = dynamic_pointer_cast<const packed_scalars>(_packed);
+        if (scalars && scalars->column().get_kind() == packed_column::kind::LONG) {
+            for (auto v : scalars->column().longs()) {
+                visitor.long_value(v);
+            }
+        } else if (scalars && scalars->column().get_kind() == packed_column::kind::DOUBLE) {
+            // whole values are visited as the longs they box to
+            for (auto v : scalars->column().doubles()) {
+                if (packed_column::is_whole(v)) {
+                    visitor.long_value(static_cast<int64_t>(v));
+                } else {
+                    visitor.double_value(v);
+                }
+            }
+        } else if (scalars && scalars->column().get_kind() == packed_column::kind::BOOLEAN) {
+            for (size_t i = 0; i < scalars->size(); ++i) {
+                visitor.boolean_value(scalars->column().boolean_at(i));
+            }
+        } else if (_packed) {
+            // packed objects are rebuilt one at a time rather than all at once
+            for (size_t i = 0; i < _packed->size(); ++i) {
+                _packed->get(i)->accept(visitor);
+            }
+        } else {
+            for (auto const& v : _value) {
+                v->accept(visitor);
+            }
+        }
+        visitor.end_list();
+    }
+
     std::shared_ptr<const simple_config_list>
     simple_config_list::modify(no_exceptions_modifier& modifier,
                                resolve_status* new_resolve_status) const
@@ -187,13 +316,16 @@ namespace hocon {
     {
         bool init = false;
         vector<shared_value> changed;
-        for (auto it = _value.begin(), endIt = _value.end(); it != endIt; ++it) {
+        for (auto it = begin(), endIt = end(); it != endIt; ++it) {
             auto modified = modifier.modify_child_may_throw({}, *it);
+            if (modifier.stopped()) {
+                return nullptr;
+            }
 
             // lazy-create the new list if required
             if (changed.empty() && modified != *it) {
-                changed.reserve(_value.size());
-                changed.insert(changed.end(), _value.begin(), it);
+                changed.reserve(size());
+                changed.insert(changed.end(), begin(), it);
                 init = true;
             }
 
@@ -1,5 +1,6 @@
 #include <internal/values/simple_config_object.hpp>
 #include <hocon/config_value.hpp>
+#include <hocon/config_value_visitor.hpp>
 #include <hocon/config_exception.hpp>
 #include <internal/simple_config_origin.hpp>
 #include <internal/resolve_context.hpp>
@@ -28,6 +29,10 @@ namespace hocon {
 
                     if (!remainder.empty()) {
                         auto result = context.restrict(remainder).resolve(v, source);
+                        if (!result.possible) {
+                            not_possible = true;
+                            return v;
+                        }
                         context = result.context.unrestricted().restrict(original_restrict);
                         return result.value;
                     } else {
@@ -38,14 +43,21 @@ namespace hocon {
                 }
             } else {
                 auto result = context.unrestricted().resolve(v, source);
+                if (!result.possible) {
+                    not_possible = true;
+                    return v;
+                }
                 context = result.context.unrestricted().restrict(original_restrict);
                 return result.value;
             }
         }
 
+        bool stopped() const override { return not_possible; }
+
         resolve_context context;
         resolve_source source;
         path original_restrict;
+        bool not_possible = false;
     };
 
     simple_config_object::simple_config_object(shared_origin origin,
@@ -64,9 +76,58 @@ namespace hocon {
         _ignores_fallbacks = false;
     }
 
+    simple_config_object::simple_config_object(shared_origin origin, deferred_entries deferred) :
+        config_object(move(origin)), _deferred(move(deferred)), _pending(true), _resolved(resolve_status::RESOLVED),
+        _ignores_fallbacks(false)
+    {}
+
+    simple_config_object::simple_config_object(shared_origin origin, shared_ptr<const simple_config_object> base,
+                                               unordered_map<string, shared_value> delta, bool ignores_fallbacks) :
+        config_object(move(origin)), _base(move(base)), _delta(move(delta)), _pending(true),
+        _resolved(resolve_status::RESOLVED), _ignores_fallbacks(ignores_fallbacks)
+    {
+        _overlay_size = _base->size();
+        for (auto const& entry : _delta) {
+            if (!_base->get(entry.first)) {
+                ++_overlay_size;
+            }
+        }
+    }
+
+    unordered_map<string, shared_value> const& simple_config_object::entries() const {
+        if (_pending.load(memory_order_acquire)) {
+            call_once(_made, [this]() {
+                if (_base) {
+                    // _delta and _base stay, since lookups may be reading them
+                    _value = _base->entries();
+                    for (auto const& entry : _delta) {
+                        _value[entry.first] = entry.second;
+                    }
+                } else {
+                    _value = _deferred();
+                    _deferred = nullptr;
+                }
+                _pending.store(false, memory_order_release);
+            });
+        }
+        return _value;
+    }
+
+    shared_value simple_config_object::overlay_get(string const& key) const {
+        auto it = _delta.find(key);
+        return it != _delta.end() ? it->second : _base->get(key);
+    }
+
+    bool simple_config_object::is_deferred() const {
+        return _pending.load(memory_order_acquire);
+    }
+
     shared_value simple_config_object::attempt_peek_with_partial_resolve(std::string const& key) const {
-        auto iter = _value.find(key);
-        if (iter != _value.end()) {
+        if (_base) {
+            return overlay_get(key);
+        }
+        auto iter = entries().find(key);
+        if (iter != entries().end()) {
             return iter->second;
         } else {
             return nullptr;
@@ -74,7 +135,7 @@ namespace hocon {
     }
 
     unordered_map<string, shared_value> const& simple_config_object::entry_set() const {
-        return _value;
+        return entries();
     }
 
     shared_object simple_config_object::with_value(path raw_path, shared_value value) const {
@@ -84,8 +145,8 @@ namespace hocon {
         if (next.empty()) {
             return with_value(key, value);
         } else {
-            if (_value.find(key) != _value.end()) {
-                shared_value child = _value.at(key);
+            if (entries().find(key) != entries().end()) {
+                shared_value child = entries().at(key);
                 if (dynamic_pointer_cast<const config_object>(child)) {
                     // if we have an object, add to it
                     return with_value(key, dynamic_pointer_cast<const config_object>(child))->with_value(next, value);
@@ -101,9 +162,9 @@ namespace hocon {
     shared_object simple_config_object::without_path(path raw_path) const {
         string key = *raw_path.first();
         path next = raw_path.remainder();
-        auto v = _value.find(key);
+        auto v = entries().find(key);
 
-        auto object = v != _value.end() ? dynamic_pointer_cast<const config_object>((*v).second) : nullptr;
+        auto object = v != entries().end() ? dynamic_pointer_cast<const config_object>((*v).second) : nullptr;
         if (object && !next.empty()) {
             auto value = object->without_path(next);
             unordered_map<string, shared_value> updated { make_pair(key, value) };
@@ -111,11 +172,11 @@ namespace hocon {
                                                      updated,
                                                      resolve_status_from_values(value_set(updated)),
                                                      _ignores_fallbacks);
-        } else if (!next.empty() || v == _value.end()) {
+        } else if (!next.empty() || v == entries().end()) {
             return dynamic_pointer_cast<const config_object>(shared_from_this());
         } else {
             unordered_map<string, shared_value> smaller;
-            for (auto&& old : _value) {
+            for (auto&& old : entries()) {
                 if (old.first != key) {
                     smaller.emplace(old);
                 }
@@ -140,11 +201,11 @@ namespace hocon {
     shared_object simple_config_object::with_only_path_or_null(path raw_path) const {
         string key = *raw_path.first();
         path next = raw_path.remainder();
-        auto v = _value.find(key);
+        auto v = entries().find(key);
 
         shared_object o;
         if (!next.empty()) {
-            auto object = v != _value.end() ? dynamic_pointer_cast<const config_object>((*v).second) : nullptr;
+            auto object = v != entries().end() ? dynamic_pointer_cast<const config_object>((*v).second) : nullptr;
             o = object->with_only_path_or_null(next);
         }
 
@@ -163,10 +224,10 @@ namespace hocon {
         }
 
         unordered_map<string, shared_value> new_map;
-        if (_value.empty()) {
+        if (entries().empty()) {
             new_map.emplace(key, value);
         } else {
-            new_map = _value;
+            new_map = entries();
             new_map.emplace(key, value);
         }
 
@@ -174,25 +235,34 @@ namespace hocon {
     }
 
     shared_value simple_config_object::new_copy(shared_origin origin) const {
-        return make_shared<simple_config_object>(move(origin), _value, _resolved, _ignores_fallbacks);
+        return make_shared<simple_config_object>(move(origin), entries(), _resolved, _ignores_fallbacks);
     }
 
     unwrapped_value simple_config_object::unwrapped() const {
         unordered_map<string, unwrapped_value> contents;
-        for (auto pair : _value) {
+        for (auto pair : entries()) {
             unwrapped_value v = pair.second->unwrapped();
             contents[pair.first] = pair.second->unwrapped();
         }
         return contents;
     }
 
+    void simple_config_object::accept(config_value_visitor& visitor) const {
+        visitor.begin_object(entries().size());
+        for (auto const& pair : entries()) {
+            visitor.key(pair.first);
+            pair.second->accept(visitor);
+        }
+        visitor.end_object();
+    }
+
     bool simple_config_object::operator==(config_value const& other) const {
         return equals<simple_config_object>(other, [&](simple_config_object const& o) {
-            if (_value.size() != o._value.size()) { return false; }
+            if (entries().size() != o.entries().size()) { return false; }
 
             bool still_equal = true;
-            for (auto pair : _value) {
-                still_equal = *(o._value.at(pair.first)) == *(_value.at(pair.first));
+            for (auto pair : entries()) {
+                still_equal = *(o.entries().at(pair.first)) == *(entries().at(pair.first));
             }
             return still_equal;
         });
@@ -209,11 +279,14 @@ namespace hocon {
 
         resolve_modifier modifier{context, move(source_with_parent)};
         auto value = modify_may_throw(modifier);
+        if (modifier.not_possible) {
+            return make_not_possible_result(modifier.context);
+        }
         return resolve_result<shared_value>(modifier.context, value);
     }
 
     shared_object simple_config_object::new_copy(resolve_status const &new_status, shared_origin new_origin) const {
-        return make_shared<simple_config_object>(move(new_origin), _value, move(new_status), ignores_fallbacks());
+        return make_shared<simple_config_object>(move(new_origin), entries(), move(new_status), ignores_fallbacks());
     }
 
     shared_ptr<simple_config_object> simple_config_object::modify(no_exceptions_modifier& modifier) const
@@ -225,10 +298,13 @@ namespace hocon {
     {
         unordered_map<string, shared_value> changes;
 
-        for (const auto& pair : _value) {
+        for (const auto& pair : entries()) {
             auto& k = pair.first;
             auto& v = pair.second;
             auto modified = the_modifier.modify_child_may_throw(k, v);
+            if (the_modifier.stopped()) {
+                return nullptr;
+            }
 
             if (modified != v) {
                 changes.emplace(k, modified);
@@ -241,7 +317,7 @@ namespace hocon {
             unordered_map<string, shared_value> modified;
             resolve_status status = resolve_status::RESOLVED;
 
-            for (const auto& pair : _value) {
+            for (const auto& pair : entries()) {
                 auto& k = pair.first;
                 auto& v = pair.second;
 
@@ -274,7 +350,7 @@ namespace hocon {
     }
 
     shared_value simple_config_object::replace_child(shared_value const &child, shared_value replacement) const {
-        unordered_map<string, shared_value> new_children(_value);
+        unordered_map<string, shared_value> new_children(entries());
 
         for (auto&& old : new_children) {
             if (old.second == child) {
@@ -295,7 +371,7 @@ namespace hocon {
     }
 
     bool simple_config_object::has_descendant(shared_value const &descendant) const {
-        auto value_list = value_set(_value);
+        auto value_list = value_set(entries());
         for (auto&& child : value_list) {
             if (child == descendant) {
                 return true;
@@ -314,7 +390,7 @@ namespace hocon {
 
     vector<string> simple_config_object::key_set() const {
         vector<string> keys;
-        for (auto const& kv : _value) {
+        for (auto const& kv : entries()) {
             keys.push_back(kv.first);
         }
         return keys;
@@ -348,16 +424,24 @@ namespace hocon {
         if (_ignores_fallbacks) {
             return shared_from_this();
         } else {
-            return make_shared<simple_config_object>(origin(), _value, _resolved, true);
+            return make_shared<simple_config_object>(origin(), entries(), _resolved, true);
         }
     }
 
+    // a resolved object merged over one at least this big, and four times its size, becomes an overlay
+    static const size_t overlay_min_base = 8;
+
     shared_value simple_config_object::merged_with_object(shared_object abstract_fallback) const {
         auto fallback = dynamic_pointer_cast<const simple_config_object>(abstract_fallback);
         if (!fallback) {
             throw bug_or_broken_exception("should not be reached (merging non-simple_config_object)");
         }
 
+        if (_resolved == resolve_status::RESOLVED && fallback->get_resolve_status() == resolve_status::RESOLVED &&
+            !is_deferred() && fallback->size() >= overlay_min_base && size() * 4 <= fallback->size()) {
+            return overlay(fallback);
+        }
+
         bool changed = false;
         auto new_resolve_status = resolve_status::RESOLVED;
         auto merged = unordered_map<string, shared_value>();
@@ -370,12 +454,12 @@ namespace hocon {
         }();
 
         for (auto const& key : all_keys) {
-            auto first = _value.find(key);
-            auto second = fallback->_value.find(key);
+            auto first = entries().find(key);
+            auto second = fallback->entries().find(key);
             auto kept = [&]() {
-                if (first == _value.end()) {
+                if (first == entries().end()) {
                     return second->second;
-                } else if (second == fallback->_value.end()) {
+                } else if (second == fallback->entries().end()) {
                     return first->second;
                 } else {
                     const auto merge = dynamic_pointer_cast<const config_value>(first->second->with_fallback(second->second));
@@ -388,7 +472,7 @@ namespace hocon {
 
             merged.insert(make_pair(key, kept));
 
-            if (first == _value.end() || first->second != kept) {
+            if (first == entries().end() || first->second != kept) {
                 changed = true;
             }
 
@@ -403,12 +487,32 @@ namespace hocon {
             return make_shared<simple_config_object>(merge_origins({shared_from_this(), fallback}),
                                                      merged, new_resolve_status, new_ignores_fallbacks);
         } else if (new_resolve_status != get_resolve_status() || new_ignores_fallbacks != ignores_fallbacks()) {
-            return make_shared<simple_config_object>(origin(), _value, new_resolve_status, new_ignores_fallbacks);
+            return make_shared<simple_config_object>(origin(), entries(), new_resolve_status, new_ignores_fallbacks);
         } else {
             return shared_from_this();
         }
     }
 
+    shared_value simple_config_object::overlay(shared_ptr<const simple_config_object> const& fallback) const {
+        // overlays of overlays keep one level, so lookups don't walk a chain
+        auto base = fallback->_base ? fallback->_base : fallback;
+        auto delta = fallback->_base ? fallback->_delta : unordered_map<string, shared_value>();
+        for (auto const& entry : _value) {
+            auto second = fallback->get(entry.first);
+            if (!second) {
+                delta[entry.first] = entry.second;
+                continue;
+            }
+            auto merged = dynamic_pointer_cast<const config_value>(entry.second->with_fallback(second));
+            if (!merged) {
+                throw bug_or_broken_exception("Expected with_fallback to return same type of object");
+            }
+            delta[entry.first] = move(merged);
+        }
+        return make_shared<simple_config_object>(merge_origins({shared_from_this(), fallback}), move(base),
+                                                 move(delta), fallback->ignores_fallbacks());
+    }
+
     bool compare(const string &a, const string &b) {
         bool a_digits = std::all_of(a.begin(), a.end(), ::isdigit);
         bool b_digits = std::all_of(b.begin(), b.end(), ::isdigit);
@@ -447,7 +551,7 @@ namespace hocon {
             sort(keys.begin(), keys.end(), compare);
             for (string const& k : keys) {
                 shared_value v;
-                v = _value.at(k);
+                v = entries().at(k);
 
                 if (options.get_origin_comments()) {
                     // split the string into a vector of keys
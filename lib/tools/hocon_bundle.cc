@@ -0,0 +1,32 @@
+#include <hocon/config_bundle.hpp>
+#include <hocon/config_exception.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Packs a tree of config files into a bundle:
+ *
+ *   hocon_bundle <bundle> <root dir> <file>...
+ *
+ * Files are given relative to the root dir, and are looked up in the bundle
+ * by that relative path.
+ */
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        cerr << "usage: " << argv[0] << " <bundle> <root dir> <file>..." << endl;
+        return 2;
+    }
+
+    vector<string> files(argv + 3, argv + argc);
+    try {
+        hocon::config_bundle::write(argv[1], argv[2], files);
+    } catch (hocon::config_exception const& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/config_object.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// kB of this process's memory that it has written to since forking
+static long private_dirty_kb() {
+    for (auto file : { "/proc/self/smaps_rollup", "/proc/self/smaps" }) {
+        ifstream in(file);
+        if (!in) {
+            continue;
+        }
+        long total = 0;
+        string key;
+        long kb;
+        while (in >> key) {
+            if (key == "Private_Dirty:" && in >> kb) {
+                total += kb;
+            }
+            in.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        return total;
+    }
+    return -1;
+}
+
+/**
+ * Measures how much of a config forked children end up copying by reading
+ * it, as parsed and frozen:
+ *
+ *   hocon_fork_bench [-c children] [-n passes] <file>
+ *
+ * Each child looks up every leaf path of the config passes times, then
+ * reports its private dirty memory, which includes whatever the lookups
+ * themselves allocate. Needs Linux's /proc/self/smaps.
+ */
+int main(int argc, char** argv) {
+    int children = 8;
+    int passes = 20;
+    string file;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if ((arg == "-c" || arg == "-n") && i + 1 < argc) {
+            int value = atoi(argv[++i]);
+            if (value < 1) {
+                cerr << arg << " must be at least 1" << endl;
+                return 2;
+            }
+            (arg == "-c" ? children : passes) = value;
+        } else {
+            file = arg;
+        }
+    }
+    if (file.empty()) {
+        cerr << "usage: " << argv[0] << " [-c children] [-n passes] <file>" << endl;
+        return 2;
+    }
+
+    hocon::shared_config conf;
+    try {
+        conf = hocon::config::parse_file_any_syntax(file)->resolve();
+    } catch (hocon::config_exception const& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    vector<string> paths;
+    for (auto const& entry : conf->entry_set()) {
+        paths.push_back(entry.first);
+    }
+
+    auto measure = [&](string const& name, hocon::shared_config const& c) {
+        long total = 0;
+        for (int child = 0; child < children; ++child) {
+            int out[2];
+            if (pipe(out) != 0) {
+                perror("pipe");
+                exit(1);
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                exit(1);
+            }
+            if (pid == 0) {
+                close(out[0]);
+                size_t found = 0;
+                for (int i = 0; i < passes; ++i) {
+                    for (auto const& p : paths) {
+                        found += c->get_value(p) != nullptr;
+                    }
+                }
+                long kb = found ? private_dirty_kb() : -1;
+                if (write(out[1], &kb, sizeof(kb)) != sizeof(kb)) {
+                    _exit(1);
+                }
+                _exit(0);
+            }
+            close(out[1]);
+            long kb = -1;
+            if (read(out[0], &kb, sizeof(kb)) != sizeof(kb) || kb < 0) {
+                cerr << "child could not measure its memory" << endl;
+                exit(1);
+            }
+            close(out[0]);
+            waitpid(pid, nullptr, 0);
+            total += kb;
+        }
+        cout << left << setw(12) << name << right << setw(22) << total / children << endl;
+    };
+
+    cout << paths.size() << " paths, " << children << " children" << endl;
+    cout << "layout      private dirty kB/child" << endl;
+    auto frozen = conf->freeze();
+    measure("as parsed", conf);
+    measure("frozen", frozen);
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/config_msgpack.hpp>
+#include <hocon/config_object.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * Compares ways of passing a resolved config to another process: rendering
+ * and parsing it again, MessagePack through config_msgpack, and CBOR of the
+ * unwrapped value through nlohmann::json:
+ *
+ *   hocon_msgpack_bench [-n round trips] <file>
+ *
+ * Each round trip encodes the config and decodes it again.
+ */
+int main(int argc, char** argv) {
+    int round_trips = 1000;
+    string file;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            round_trips = atoi(argv[++i]);
+            if (round_trips < 1) {
+                cerr << "-n must be at least 1" << endl;
+                return 2;
+            }
+        } else {
+            file = arg;
+        }
+    }
+    if (file.empty()) {
+        cerr << "usage: " << argv[0] << " [-n round trips] <file>" << endl;
+        return 2;
+    }
+
+    hocon::shared_object root;
+    try {
+        root = hocon::config::parse_file_any_syntax(file)->resolve()->root();
+    } catch (hocon::config_exception const& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    auto options = hocon::config_render_options::concise();
+    auto measure = [&](string const& name, function<size_t()> round_trip) {
+        size_t size = round_trip();
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < round_trips; ++i) {
+            round_trip();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        cout << left << setw(22) << name << right << setw(10) << size
+             << setw(12) << fixed << setprecision(0) << round_trips / elapsed.count() << endl;
+    };
+
+    cout << "format                     bytes  round trips/s" << endl;
+    measure("render + parse", [&]() {
+        auto text = root->render(options);
+        hocon::config::parse_string(text)->resolve();
+        return text.size();
+    });
+    measure("msgpack", [&]() {
+        auto bytes = hocon::config_msgpack::encode(root);
+        hocon::config_msgpack::decode(bytes);
+        return bytes.size();
+    });
+    measure("msgpack with origins", [&]() {
+        auto bytes = hocon::config_msgpack::encode(root, true);
+        hocon::config_msgpack::decode(bytes);
+        return bytes.size();
+    });
+    measure("cbor of unwrapped", [&]() {
+        auto bytes = hocon::unwrapped_value::to_cbor(root->unwrapped());
+        hocon::unwrapped_value::from_cbor(bytes);
+        return bytes.size();
+    });
+    return 0;
+}
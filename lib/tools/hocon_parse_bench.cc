@@ -0,0 +1,97 @@
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/config_parse_options.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Measures how parse-and-resolve throughput scales with threads, each thread
+ * loading the given files independently:
+ *
+ *   hocon_parse_bench [-t max threads] [-n loads per thread] [-p parse threads] <file>...
+ *
+ * Thread counts double from 1 up to the maximum, which defaults to the number
+ * of hardware threads. -p sets how many threads each load builds values on.
+ */
+int main(int argc, char** argv) {
+    unsigned max_threads = max(1u, thread::hardware_concurrency());
+    int loads = 200;
+    unsigned parse_threads = 1;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if ((arg == "-t" || arg == "-n" || arg == "-p") && i + 1 < argc) {
+            int value = atoi(argv[++i]);
+            if (value < 1) {
+                cerr << arg << " must be at least 1" << endl;
+                return 2;
+            }
+            if (arg == "-t") {
+                max_threads = static_cast<unsigned>(value);
+            } else if (arg == "-p") {
+                parse_threads = static_cast<unsigned>(value);
+            } else {
+                loads = value;
+            }
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        cerr << "usage: " << argv[0] << " [-t max threads] [-n loads per thread] [-p parse threads] <file>..." << endl;
+        return 2;
+    }
+
+    auto options = hocon::config_parse_options().set_parse_threads(parse_threads);
+    auto load_all = [&]() {
+        for (auto& file : files) {
+            hocon::config::parse_file_any_syntax(file, options)->resolve();
+        }
+    };
+    try {
+        // fail early on a bad file, and warm up
+        load_all();
+    } catch (hocon::config_exception const& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    double single_rate = 0;
+    cout << "threads  loads/s  speedup" << endl;
+    for (unsigned threads : thread_counts) {
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                for (int i = 0; i < loads; ++i) {
+                    load_all();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        double rate = threads * loads * files.size() / elapsed.count();
+        if (threads == 1) {
+            single_rate = rate;
+        }
+        cout << setw(7) << threads << setw(9) << fixed << setprecision(0) << rate
+             << setw(9) << setprecision(2) << rate / single_rate << endl;
+    }
+    return 0;
+}
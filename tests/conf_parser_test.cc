@@ -4,14 +4,22 @@
 
 #include <boost/algorithm/string/replace.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
 #include <hocon/config.hpp>
 #include <hocon/config_list.hpp>
+#include <hocon/config_bundle.hpp>
+#include <hocon/config_source_provider.hpp>
 #include <hocon/config_exception.hpp>
 #include <hocon/config_parse_options.hpp>
 #include <internal/values/simple_config_object.hpp>
 #include <internal/values/config_reference.hpp>
 #include <internal/substitution_expression.hpp>
 #include <internal/parseable.hpp>
+#include <internal/decompressing_stream.hpp>
 #include <internal/resolve_context.hpp>
 #include <internal/path_parser.hpp>
 #include "test_utils.hpp"
@@ -172,6 +180,31 @@ TEST_CASE("duplicate key object number object") {
     REQUIRE(2 == obj->get_int("a.c"));
 }
 
+TEST_CASE("dotted keys sharing a prefix are merged") {
+    auto obj = parse_config(R"(a.b.x = 1
+a.b.y = 2
+a { b { z : 3 }, c : 4 }
+a.b.x = 42
+a.c.d = 5
+a.e = ${a.b.y})")->resolve();
+    REQUIRE(1u == obj->root()->size());
+    REQUIRE(3u == obj->get_object("a")->size());
+    REQUIRE(3u == obj->get_object("a.b")->size());
+    REQUIRE(42 == obj->get_int("a.b.x"));
+    REQUIRE(2 == obj->get_int("a.b.y"));
+    REQUIRE(3 == obj->get_int("a.b.z"));
+    REQUIRE(1u == obj->get_object("a.c")->size());
+    REQUIRE(5 == obj->get_int("a.c.d"));
+    REQUIRE(2 == obj->get_int("a.e"));
+}
+
+TEST_CASE("dotted key object over value and value over dotted key object") {
+    auto obj = parse_config(R"(a.b = 1, a.b.c = 2, d.e.f = 3, d.e = 4)");
+    REQUIRE(1u == obj->get_object("a.b")->size());
+    REQUIRE(2 == obj->get_int("a.b.c"));
+    REQUIRE(4 == obj->get_int("d.e"));
+}
+
 TEST_CASE("implied comma handling") {
     auto valids = {
         R"(
@@ -638,6 +671,94 @@ TEST_CASE("include file relative paths") {
     REQUIRE("abcd" == conf->get_string("root.strings.abcdAgain"));
 }
 
+TEST_CASE("parse compressed files") {
+    auto plain = config::parse_file_any_syntax(fixture_path("test01.conf"))->resolve();
+    if (compression_supported(compression::GZIP)) {
+        auto conf = config::parse_file_any_syntax(fixture_path("test01.conf.gz"))->resolve();
+        REQUIRE(*plain->root() == *conf->root());
+
+        auto included = config::parse_string("root { include file(\"" + fixture_path("test01.conf.gz") + "\") }");
+        REQUIRE("abcd" == included->get_string("root.strings.abcdAgain"));
+
+        // detected from the magic bytes without the extension
+        ifstream gz_file(fixture_path("test01.conf.gz"), ios::binary);
+        string gz(istreambuf_iterator<char>(gz_file), (istreambuf_iterator<char>()));
+        auto options = config_parse_options().set_allow_missing(false)
+            .set_source_provider(config_source_provider::in_memory({ { "test01.conf", gz }, { "truncated.conf", gz.substr(0, gz.size() / 2) } }));
+        REQUIRE(*plain->root() == *config::parse_file_any_syntax("test01.conf", options)->resolve()->root());
+        REQUIRE_THROWS_AS(config::parse_file_any_syntax("truncated.conf", options), io_exception);
+    } else {
+        REQUIRE_THROWS_AS(config::parse_file_any_syntax(fixture_path("test01.conf.gz"),
+                                                        config_parse_options().set_allow_missing(false)), io_exception);
+    }
+
+    if (compression_supported(compression::ZSTD)) {
+        auto conf = config::parse_file_any_syntax(fixture_path("test01.json.zst"));
+        REQUIRE(*config::parse_file_any_syntax(fixture_path("test01.json"))->root() == *conf->root());
+        REQUIRE(1 == conf->get_int("fromJson1"));
+    }
+}
+
+TEST_CASE("prefetching reads each include once, ahead of the parser") {
+    struct counting_provider : config_source_provider {
+        shared_source_provider files = config_source_provider::in_memory({
+            { "app/main.conf", "include \"common.conf\"\nmain : ${common}\ninclude file(\"app/sub/leaf\")" },
+            { "app/common.conf", "common : 1\ninclude \"sub/leaf.conf\"" },
+            { "app/sub/leaf.conf", "leaf : true" },
+        });
+        mutable mutex lock;
+        mutable unordered_map<string, int> reads;
+
+        bool open(string const& name, config_source& source) const override {
+            {
+                lock_guard<mutex> held(lock);
+                ++reads[name];
+            }
+            return files->open(name, source);
+        }
+    };
+    auto files = make_shared<counting_provider>();
+
+    auto load = [&](shared_ptr<prefetching_source_provider> provider) {
+        auto options = config_parse_options().set_source_provider(provider);
+        return config::parse_file_any_syntax("app/main.conf", options)->resolve();
+    };
+    auto first = make_shared<prefetching_source_provider>(vector<string>(), files, 2);
+    auto conf = load(first);
+    REQUIRE(1 == conf->get_int("main"));
+    REQUIRE(conf->get_bool("leaf"));
+    auto opened = first->opened();
+    first.reset();
+    for (auto const& read : files->reads) {
+        REQUIRE(1 == read.second);
+    }
+    REQUIRE("app/main.conf" == opened.front());
+    REQUIRE(opened.end() != find(opened.begin(), opened.end(), "app/common.conf"));
+    REQUIRE(opened.end() != find(opened.begin(), opened.end(), "app/sub/leaf.conf"));
+
+    // a previous load's sources make a manifest for the next
+    files->reads.clear();
+    auto second = make_shared<prefetching_source_provider>(opened, files, 2);
+    REQUIRE(*conf->root() == *load(second)->root());
+    REQUIRE(opened == second->opened());
+    second.reset();
+    for (auto const& name : opened) {
+        REQUIRE(1 == files->reads[name]);
+    }
+
+    // what a read throws comes out of open, whether it was read ahead or not
+    struct failing_provider : config_source_provider {
+        bool open(string const& name, config_source&) const override {
+            throw io_exception(simple_config_origin(name), "could not read " + name);
+        }
+    };
+    prefetching_source_provider failing({ "ahead.conf" }, make_shared<failing_provider>(), 1);
+    config_source source;
+    REQUIRE_THROWS_AS(failing.open("ahead.conf", source), io_exception&);
+    REQUIRE_THROWS_AS(failing.open("ahead.conf", source), io_exception&);
+    REQUIRE_THROWS_AS(failing.open("late.conf", source), io_exception&);
+}
+
 TEST_CASE("include file with extension") {
     auto conf = config::parse_string("include file(\"" + fixture_path("test01.conf") + "\")");
 
@@ -735,3 +856,217 @@ TEST_CASE("parse files") {
     REQUIRE("nick" == conf2->get_string("other_field.nick_name"));
     REQUIRE("qwer.,m" == conf2->get_string("other_field.new_passwd"));
 }
+
+TEST_CASE("parse files from a bundle") {
+    string dir = string(TEST_FILE_DIR) + "/simple_confs";
+    temp_file bundle_file("simple_confs_test.bundle");
+    config_bundle::write(bundle_file.path, dir, { "a.conf", "b.conf", "d.conf", "sub/b.conf", "sub/./c.conf", "sub/e.conf" });
+    auto bundle = config_bundle::open(bundle_file.path);
+
+    REQUIRE((vector<string> { "a.conf", "b.conf", "d.conf", "sub/b.conf", "sub/c.conf", "sub/e.conf" }) == bundle->paths());
+    REQUIRE(bundle->contains("sub/../d.conf"));
+    REQUIRE_FALSE(bundle->contains("missing.conf"));
+    REQUIRE(bundle->source("missing.conf").empty());
+    ifstream d_file(dir + "/d.conf");
+    auto d_source = bundle->source("d.conf");
+    REQUIRE(string(istreambuf_iterator<char>(d_file), istreambuf_iterator<char>()) == string(d_source.begin(), d_source.end()));
+
+    auto from_bundle = bundle->parse_file("a.conf")->resolve();
+    auto from_files = config::parse_file_any_syntax(dir + "/a.conf")->resolve();
+    REQUIRE(*from_files->root() == *from_bundle->root());
+    REQUIRE("qwer.,m" == from_bundle->get_string("Peter.passwd4"));
+    REQUIRE(from_bundle->get_value("Peter.passwd5")->origin()->description().find("in bundle") != string::npos);
+
+    auto sub = bundle->parse_file("sub/b.conf")->resolve();
+    REQUIRE("nick" == sub->get_string("other_field.nick_name"));
+    REQUIRE("qwer.,m" == sub->get_string("other_field.new_passwd"));
+
+    REQUIRE_THROWS_AS(bundle->parse_file("missing.conf"), io_exception);
+    REQUIRE_THROWS_AS(config_bundle::open(dir + "/a.conf"), io_exception);
+
+    // swapping the paths of the first two index entries unsorts the index
+    ifstream in(bundle_file.path, ios::binary);
+    string bytes { istreambuf_iterator<char>(in), istreambuf_iterator<char>() };
+    for (size_t i = 0; i < 16; ++i) {
+        swap(bytes[16 + i], bytes[48 + i]);
+    }
+    temp_file unsorted_file("unsorted.bundle");
+    ofstream(unsorted_file.path, ios::binary) << bytes;
+    REQUIRE_THROWS_AS(config_bundle::open(unsorted_file.path), io_exception);
+}
+
+TEST_CASE("includes are read through the source provider") {
+    auto provider = config_source_provider::in_memory({
+        { "app/main.conf", "include \"common.conf\"\nname : main, limits : { include \"../shared/limits.conf\" }" },
+        { "app/common.conf", "name : common, debug : true" },
+        { "shared/limits.conf", "max : 10" },
+    });
+    auto options = config_parse_options().set_source_provider(provider);
+    REQUIRE(provider == options.set_allow_missing(false).get_source_provider());
+
+    auto conf = config::parse_file_any_syntax("app/main.conf", options)->resolve();
+    REQUIRE("main" == conf->get_string("name"));
+    REQUIRE(conf->get_bool("debug"));
+    REQUIRE(10 == conf->get_int("limits.max"));
+    REQUIRE(config::parse_file_any_syntax("app/missing.conf", options)->root()->is_empty());
+    REQUIRE_THROWS_AS(config::parse_file_any_syntax("app/missing.conf", options.set_allow_missing(false)), io_exception);
+
+    string dir = string(TEST_FILE_DIR) + "/simple_confs";
+    temp_file bundle_file("simple_confs_provider_test.bundle");
+    config_bundle::write(bundle_file.path, dir, { "a.conf", "b.conf", "d.conf" });
+    auto bundle_options = config_parse_options().set_source_provider(config_source_provider::bundle(config_bundle::open(bundle_file.path)));
+    auto from_bundle = config::parse_file_any_syntax("a.conf", bundle_options)->resolve();
+    auto from_files = config::parse_file_any_syntax(dir + "/a.conf")->resolve();
+    REQUIRE(*from_files->root() == *from_bundle->root());
+}
+
+TEST_CASE("independent loads can run concurrently") {
+    string file = string(TEST_FILE_DIR) + "/simple_confs/a.conf";
+    string text = "base : { x : 1, y : ${base.x} }, derived : ${base} { z : ${?HOME} }, list : [${base.x}, 2] [3]";
+    auto expected_file = config::parse_file_any_syntax(file)->resolve()->root()->unwrapped();
+    auto expected_text = config::parse_string(text)->resolve()->root()->unwrapped();
+
+    vector<thread> threads;
+    vector<int> mismatches(8, 0);
+    for (size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 25; ++i) {
+                // the same parse options and includer are shared by every thread
+                if (config::parse_file_any_syntax(file)->resolve()->root()->unwrapped() != expected_file ||
+                    config::parse_string(text)->resolve()->root()->unwrapped() != expected_text) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    REQUIRE(vector<int>(mismatches.size(), 0) == mismatches);
+}
+
+TEST_CASE("lazy parsing defers object bodies until they're used") {
+    string text = R"(# the database
+db {
+    host : "db.local"   // primary
+    ports : [5432, 5433]
+    pool { min : 1, max : { hard : 20 } }
+    note : """has { braces } and "quotes" """
+}
+name : "x { y"
+a.b : 1
+a { c : 2 }
+services : { web : { port : 80 }, "api" : { port : 8080, tags : [ { t : "}" } ] } }, level : 3
+concatenated : { x : 1 } { y : 2 }
+)";
+    auto eager = config::parse_string(text);
+    auto lazy_options = config_parse_options().set_lazy(true);
+    auto lazy = config::parse_string(text, lazy_options);
+
+    auto deferred = [](shared_config const& conf, string const& path) {
+        auto object = dynamic_pointer_cast<const simple_config_object>(conf->get_value(path));
+        return object && object->is_deferred();
+    };
+    REQUIRE(deferred(lazy, "db"));
+    REQUIRE(deferred(lazy, "services"));
+    REQUIRE_FALSE(deferred(lazy, "a"));
+    REQUIRE_FALSE(deferred(lazy, "concatenated"));
+
+    REQUIRE(20 == lazy->get_int("db.pool.max.hard"));
+    REQUIRE_FALSE(deferred(lazy, "db"));
+    REQUIRE(deferred(lazy, "db.pool.max") == false);
+    REQUIRE(deferred(lazy, "services"));
+    REQUIRE(4 == lazy->get_value("db.pool")->origin()->line_number());
+
+    REQUIRE(eager->root()->unwrapped() == lazy->root()->unwrapped());
+    REQUIRE(eager->root()->render() == lazy->root()->render());
+
+    SECTION("documents that need resolving are parsed up front") {
+        auto with_substitution = config::parse_string("a { b : 1 }, c { d : ${a.b} }", lazy_options);
+        REQUIRE_FALSE(deferred(with_substitution, "a"));
+        REQUIRE(1 == with_substitution->resolve()->get_int("c.d"));
+    }
+
+    SECTION("syntax errors in a body are reported when it's used") {
+        auto broken = config::parse_string("ok : 1, bad { x : : 1 }", lazy_options);
+        REQUIRE(1 == broken->get_int("ok"));
+        REQUIRE_THROWS_AS(broken->get_int("bad.x"), config_exception);
+    }
+
+    SECTION("bodies can be parsed from several threads at once") {
+        string big;
+        for (int i = 0; i < 50; ++i) {
+            big += "s" + to_string(i) + " { v : " + to_string(i) + ", nested { w : [1, 2, 3] } }\n";
+        }
+        auto conf = config::parse_string(big, lazy_options);
+        vector<thread> threads;
+        vector<int> sums(4, 0);
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < 50; ++i) {
+                    sums[t] += conf->get_int("s" + to_string(i) + ".v");
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        for (int sum : sums) {
+            REQUIRE(1225 == sum);
+        }
+    }
+}
+
+TEST_CASE("values of large fields can be built on several threads") {
+    string text = "# the first field\n";
+    for (int i = 0; i < 40; ++i) {
+        text += "f" + to_string(i) + " {  # field " + to_string(i) + "\n";
+        for (int j = 0; j < 10; ++j) {
+            text += "    k" + to_string(j) + " : [" + to_string(i) + ", " + to_string(j) + ", { x : y }]\n";
+        }
+        text += "    // the nested one\n    nested.deep { s : \"" + to_string(i) + "\" }\n}\n";
+        // duplicates are merged in document order
+        text += "f" + to_string(i % 3) + " { k0 : " + to_string(i) + ", extra" + to_string(i) + " : true }\n";
+    }
+    text += "small : 1, f5.k1 : overridden\n";
+    auto parallel_options = config_parse_options().set_parse_threads(4);
+
+    auto sequential = config::parse_string(text);
+    auto parallel = config::parse_string(text, parallel_options);
+    REQUIRE(sequential->root()->render() == parallel->root()->render());
+    REQUIRE(sequential->root()->unwrapped() == parallel->root()->unwrapped());
+    REQUIRE(39 == parallel->get_int("f0.k0"));
+    REQUIRE("overridden" == parallel->get_string("f5.k1"));
+    REQUIRE(20 == parallel->get_value("f1.k2")->origin()->line_number());
+
+    // config::parse_string ignores errors unless allow_missing is off, which it doesn't pass on
+    auto error = [](string const& input, config_parse_options options) {
+        options = options.set_allow_missing(false);
+        try {
+            parseable::new_string(input, options)->parse(options);
+        } catch (config_exception const& e) {
+            return string(e.what());
+        }
+        return string();
+    };
+
+    SECTION("the first error in the document is reported") {
+        string broken = text + "late { a : [ { b += 1 } ] }\n";
+        broken.insert(broken.find("f7 {") + 4, " early : [ { c += 1 } ]\n");
+        auto expected = error(broken, config_parse_options());
+        REQUIRE(expected.find("+= does not work nested inside a list") != string::npos);
+        REQUIRE(expected == error(broken, parallel_options));
+    }
+
+    SECTION("JSON duplicates are reported like on one thread") {
+        string json = "{ \"a\" : { \"x\" : [0";
+        for (int i = 1; i < 50; ++i) {
+            json += ", " + to_string(i);
+        }
+        json += "] },\n  \"b\" : 1,\n  \"a\" : 2 }";
+        auto json_options = config_parse_options().set_syntax(config_syntax::JSON);
+        auto expected = error(json, json_options);
+        REQUIRE(expected.find("JSON does not allow duplicate fields") != string::npos);
+        REQUIRE(expected == error(json, json_options.set_parse_threads(4)));
+    }
+}
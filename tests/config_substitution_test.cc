@@ -2,10 +2,13 @@
 #include "test_utils.hpp"
 
 #include <hocon/config.hpp>
+#include <internal/values/simple_config_list.hpp>
 #include <internal/values/simple_config_object.hpp>
 
 #include <internal/resolve_result.hpp>
 #include <hocon/config_resolve_options.hpp>
+#include <hocon/config_resolve_cache.hpp>
+#include <hocon/config_parse_options.hpp>
 #include <internal/resolve_context.hpp>
 #include <hocon/config_exception.hpp>
 #include <internal/values/config_delayed_merge_object.hpp>
@@ -677,6 +680,70 @@ TEST_CASE("optional vanishes from array") {
     REQUIRE(list == resolved->get_int_list("a"));
 }
 
+TEST_CASE("optional misses and optional self references drop out") {
+    auto obj = parse_object("{ a : 1, a : ${?NOT_HERE}, b : ${?b}, c : { d : ${?NOT_HERE}, e : ${?c.e} }, f : \"x\"${?NOT_HERE} }");
+    auto resolved = resolve(obj);
+    REQUIRE(1u == resolved->get_int("a"));
+    REQUIRE_FALSE(resolved->has_path_or_null("b"));
+    REQUIRE(resolved->get_object("c")->is_empty());
+    REQUIRE("x" == resolved->get_string("f"));
+
+    // the environment isn't read, so variables that are set miss too
+    REQUIRE_FALSE(config::parse_string("p : ${?PATH}")->resolve()->has_path("p"));
+}
+
+TEST_CASE("missing nested key keeps its exception type") {
+    auto resolved = resolve(parse_object("{ a : { b : 1 } }"));
+    REQUIRE_THROWS_AS(resolved->get_int("a.c"), missing_exception&);
+    REQUIRE_THROWS_AS(resolved->get_int("x.y.z"), missing_exception&);
+}
+
+
+TEST_CASE("resolve cache reuses results for configs with the same structure") {
+    auto cache = make_shared<config_resolve_cache>(2);
+    auto options = config_resolve_options().set_cache(cache);
+    string text = "defaults { port : 80, hosts : [a, b] }, web : ${defaults} { port : 8080 }, name : web-${web.port}";
+
+    auto first = config::parse_string(text)->resolve(options);
+    REQUIRE(0u == cache->stats().hits);
+    REQUIRE(1u == cache->stats().misses);
+    REQUIRE(0u < cache->stats().memory_usage);
+    auto second = config::parse_string(text, config_parse_options().set_origin_description(make_shared<string>("other")))->resolve(options);
+    REQUIRE(1u == cache->stats().hits);
+    REQUIRE(first->root() == second->root());
+    REQUIRE("web-8080" == second->get_string("name"));
+
+    // differences in substitutions, values or options miss
+    REQUIRE("web-8081" == config::parse_string(text + ", web.port : 8081")->resolve(options)->get_string("name"));
+    auto optional = config::parse_string("a : ${?missing}, b : 1");
+    auto required = config::parse_string("a : ${missing}, b : 1");
+    REQUIRE_FALSE(optional->resolve(options)->has_path("a"));
+    REQUIRE_THROWS_AS(required->resolve(options), unresolved_substitution_exception);
+    REQUIRE_FALSE(required->resolve(options.set_allow_unresolved(true))->is_resolved());
+    REQUIRE(1u == cache->stats().hits);
+
+    // configs without substitutions share one instance
+    auto plain = config::parse_string("x : { y : [1, 2] }")->resolve(options);
+    REQUIRE(plain->root() == config::parse_string("x : { y : [1, 2] }")->resolve(options)->root());
+    REQUIRE(2u == cache->stats().entries);
+    REQUIRE(2u == cache->stats().hits);
+
+    cache->clear();
+    REQUIRE(0u == cache->stats().entries);
+    REQUIRE(0u == cache->stats().memory_usage);
+
+    // packed lists are hashed and measured without unpacking them
+    string numbers = "n : [";
+    for (int i = 0; i < 100; ++i) {
+        numbers += to_string(i) + ",";
+    }
+    auto packed = config::parse_string(numbers + "]")->resolve(options);
+    auto list = dynamic_pointer_cast<const simple_config_list>(packed->get_list("n"));
+    REQUIRE(list->packed());
+    auto usage = list->memory_usage();
+    REQUIRE(packed->root() == config::parse_string(numbers + "]")->resolve(options)->root());
+    REQUIRE(usage == list->memory_usage());
+}
 
 TEST_CASE("subst self references") {
     SECTION("subst self reference") {
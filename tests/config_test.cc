@@ -1,9 +1,21 @@
 #include <catch.hpp>
 
 #include <hocon/config.hpp>
+#include <hocon/config_batch_resolver.hpp>
+#include <hocon/config_budget.hpp>
+#include <hocon/config_history.hpp>
+#include <hocon/config_path_index.hpp>
+#include <hocon/config_schema.hpp>
+#include <internal/config_arena.hpp>
+#include <internal/path_filter.hpp>
+#include <internal/values/config_string.hpp>
+#include <internal/values/simple_config_list.hpp>
 #include "fixtures.hpp"
 #include "test_utils.hpp"
 
+#include <chrono>
+#include <thread>
+
 using namespace std;
 using namespace hocon;
 using namespace hocon::test_utils;
@@ -149,3 +161,396 @@ TEST_CASE("should correctly parse durations", "[config]") {
         REQUIRE_THROWS(conf->get_duration("durations.largeDays", time_unit::NANOSECONDS));
     }
 }
+
+TEST_CASE("path index answers prefix queries", "[config]") {
+    auto conf = config::parse_string(
+        "features { search : true, beta { ui : on, api : off }, empty {}, gone : null }\n"
+        "tenants { acme { quota : 10 }, \"a.b\" { quota : 20 } }\n"
+        "top : [1, 2]\n")->resolve();
+    config_path_index index(*conf);
+
+    REQUIRE(conf->entry_set().size() == index.count(""));
+    REQUIRE(6u == index.count(""));
+    REQUIRE(3u == index.count("features"));
+    REQUIRE(2u == index.count("features.beta"));
+    REQUIRE(1u == index.count("features.beta.ui"));
+    REQUIRE(0u == index.count("features.beta.ui.more"));
+    REQUIRE(0u == index.count("nothing"));
+
+    REQUIRE(index.has_prefix("tenants.acme"));
+    REQUIRE(index.has_prefix("tenants.\"a.b\".quota"));
+    REQUIRE(index.has_prefix("top"));
+    REQUIRE_FALSE(index.has_prefix("tenants.a"));
+    REQUIRE_FALSE(index.has_prefix("features.empty"));
+    REQUIRE_FALSE(index.has_prefix("features.gone"));
+
+    REQUIRE((vector<string> { "features.beta.api", "features.beta.ui", "features.search" }) == index.paths_with_prefix("features"));
+    REQUIRE((vector<string> { "tenants.\"a.b\".quota", "tenants.acme.quota" }) == index.paths_with_prefix("tenants"));
+    REQUIRE((vector<string> { "top" }) == index.paths_with_prefix("top"));
+    REQUIRE(index.paths_with_prefix("features.empty").empty());
+
+    // keys repeated across many paths are stored once, so the index is smaller than the paths it holds
+    string services;
+    for (int i = 0; i < 10; ++i) {
+        services += "service_number_" + to_string(i) + " {";
+        for (int j = 0; j < 10; ++j) {
+            services += " setting_with_a_long_name_" + to_string(j) + " : " + to_string(j) + ",";
+        }
+        services += " }\n";
+    }
+    auto services_conf = config::parse_string(services)->resolve();
+    config_path_index services_index(*services_conf);
+    REQUIRE(100u == services_index.count(""));
+    size_t rendered_usage = 0;
+    for (auto const& entry : services_conf->entry_set()) {
+        rendered_usage += sizeof(string) + entry.first.size() + 1;
+    }
+    REQUIRE(services_index.memory_usage() * 2 < rendered_usage);
+
+    REQUIRE_THROWS_AS(config_path_index(*config::parse_string("a : ${b}, b : 1")), not_resolved_exception);
+}
+
+TEST_CASE("config history shares unchanged subtrees between generations") {
+    auto services = [](int changed_port) {
+        string s;
+        for (int i = 0; i < 20; ++i) {
+            s += "s" + to_string(i) + " : { port : " + to_string(i == 3 ? changed_port : 8000 + i) + ", hosts : [a, b], tls : true }\n";
+        }
+        return "services { " + s + " }";
+    };
+    auto first = config::parse_string(services(8003) + ", version : 1")->resolve();
+    auto second = config::parse_string(services(9000) + ", version : 2")->resolve();
+
+    config_history history(2);
+    REQUIRE(1u == history.push(first));
+    size_t one_generation = history.shared_values();
+    REQUIRE(2u == history.push(second));
+    REQUIRE(second->root()->unwrapped() == history.get(2)->root()->unwrapped());
+    // only the root, services, s3, its port and the version are stored again
+    REQUIRE(one_generation + 5 == history.shared_values());
+    REQUIRE(history.get(1)->get_value("services.s0") == history.get(2)->get_value("services.s0"));
+
+    auto changes = history.diff(1, 2);
+    REQUIRE(2u == changes.size());
+    REQUIRE("services.s3.port" == changes[0].path);
+    REQUIRE(8003 == changes[0].before->unwrapped().get<int>());
+    REQUIRE(9000 == changes[0].after->unwrapped().get<int>());
+    REQUIRE("version" == changes[1].path);
+    REQUIRE(history.diff(2, 2).empty());
+
+    auto smaller = config::parse_string("services { s0 : { port : 8000, hosts : [a, b], tls : true } }, version : 1, extra : 1");
+    auto removed = config_history::diff(first, smaller->resolve());
+    REQUIRE(1u + 19 * 3 == removed.size());
+    REQUIRE("extra" == removed[0].path);
+    REQUIRE_FALSE(removed[0].before);
+    REQUIRE("services.s1.hosts" == removed[1].path);
+    REQUIRE_FALSE(removed[1].after);
+
+    history.push(first);
+    REQUIRE(2u == history.oldest());
+    REQUIRE(3u == history.latest());
+    REQUIRE_FALSE(history.contains(1));
+    REQUIRE_THROWS_AS(history.get(1), config_exception);
+    REQUIRE(one_generation + 5 == history.shared_values());
+    REQUIRE_THROWS_AS(history.push(config::parse_string("a : ${b}, b : 1")), not_resolved_exception);
+
+    // packed lists are told apart by their contents, and aren't unpacked to do it
+    string lists;
+    for (int l = 0; l < 4; ++l) {
+        lists += "l" + to_string(l) + " : [";
+        for (int i = 0; i < 20; ++i) {
+            lists += to_string(i * (l % 3 + 1)) + ",";
+        }
+        lists += "]\n";
+    }
+    config_history packed_history(1);
+    packed_history.push(config::parse_string(lists)->resolve());
+    auto interned = packed_history.get(1);
+    REQUIRE(interned->get_list("l0") == interned->get_list("l3"));
+    REQUIRE(interned->get_list("l0") != interned->get_list("l1"));
+    REQUIRE(interned->get_list("l1") != interned->get_list("l2"));
+    auto packed_hash = [&](string const& key) {
+        return dynamic_pointer_cast<const simple_config_list>(interned->get_list(key))->packed()->hash();
+    };
+    REQUIRE(packed_hash("l0") == packed_hash("l3"));
+    REQUIRE(packed_hash("l0") != packed_hash("l1"));
+    REQUIRE(packed_hash("l1") != packed_hash("l2"));
+}
+
+TEST_CASE("path filter answers lookups of missing paths") {
+    auto conf = config::parse_string(R"(
+        flags { new-ui : true, beta_search : false, "dotted.key" : 1, "9lives" : 2, off : null }
+        limits { max : 10, nested { deep : [1, 2] } }
+    )")->resolve();
+    auto filtered = conf->with_path_filter();
+    REQUIRE(conf->root() == filtered->root());
+
+    for (auto path : { "flags", "flags.new-ui", "flags.beta_search", "flags.\"dotted.key\"", "flags.9lives",
+                       "limits.nested.deep", "flags.off", "flags.missing", "missing", "limits.max.below",
+                       "flags.\"9lives\"", "limits . max" }) {
+        CAPTURE(path);
+        REQUIRE(conf->has_path(path) == filtered->has_path(path));
+        REQUIRE(conf->has_path_or_null(path) == filtered->has_path_or_null(path));
+    }
+    REQUIRE_THROWS_AS(filtered->has_path("flags..off"), bad_path_exception);
+
+    // with ten bits per path, nearly every miss is answered by the filter
+    auto filter = path_filter::build(conf->root());
+    int answered = 0;
+    for (int i = 0; i < 1000; ++i) {
+        answered += filter->definitely_absent("flags.missing" + to_string(i));
+    }
+    REQUIRE(950 < answered);
+    REQUIRE_FALSE(filter->definitely_absent("limits.nested"));
+    REQUIRE_FALSE(filter->definitely_absent("flags.\"missing\""));
+    REQUIRE_THROWS_AS(config::parse_string("a : ${b}, b : 1")->with_path_filter(), not_resolved_exception);
+}
+
+TEST_CASE("config arenas hand out memory back to back") {
+    config_arena arena(256);
+    auto first = static_cast<char*>(arena.allocate(20, 4));
+    REQUIRE(first + 24 == arena.allocate(8, 8));
+    REQUIRE(first + 32 == arena.allocate(16, 16));
+    REQUIRE(48 == arena.bytes_used());
+    REQUIRE(nullptr != arena.allocate(1000, 8));
+}
+
+TEST_CASE("frozen configs are read without counting references") {
+    auto conf = config::parse_string("a { b : 1, c : [x, y], d { e : true } }, s : ${a.b}\"-text\"")->resolve();
+    auto frozen = conf->freeze();
+    REQUIRE(*conf->root() == *frozen->root());
+
+    // nothing handed out owns the values, so copying them writes nothing
+    REQUIRE(0 == frozen->root().use_count());
+    REQUIRE(0 == frozen->get_value("a.d.e").use_count());
+    REQUIRE(0 == frozen->get_list("a.c")->get(1).use_count());
+    REQUIRE("1-text" == frozen->get_string("s"));
+    REQUIRE(frozen->get_value("a.d") == frozen->get_value("a.d"));
+
+    // the values still know how to share themselves
+    REQUIRE(frozen->get_object("a.d")->to_config()->get_bool("e"));
+
+    REQUIRE_THROWS_AS(config::parse_string("a : ${b}, b : 1")->freeze(), not_resolved_exception);
+}
+
+TEST_CASE("lookups that coerce or iterate don't write to frozen configs") {
+    auto conf = config::parse_string("n : \"42\", numbers : [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16.5]")
+                    ->resolve();
+    REQUIRE(dynamic_pointer_cast<const simple_config_list>(conf->get_list("numbers"))->packed());
+    auto frozen = conf->freeze();
+    REQUIRE(*conf->root() == *frozen->root());
+
+    // strings coerce every time instead of keeping what they coerced to
+    auto n = dynamic_pointer_cast<const config_string>(frozen->get_value("n"));
+    int coercions = 0;
+    auto coerce = [&]() { ++coercions; return conf->get_value("n"); };
+    n->memoized_coercion(config_value::type::NUMBER, coerce);
+    n->memoized_coercion(config_value::type::NUMBER, coerce);
+    REQUIRE(2 == coercions);
+    REQUIRE(42 == frozen->get_int("n"));
+    REQUIRE(42 == frozen->get_int("n"));
+
+    // lists are stored unpacked, so iterating them has nothing to fill in
+    auto list = dynamic_pointer_cast<const simple_config_list>(frozen->get_list("numbers"));
+    REQUIRE_FALSE(list->packed());
+    REQUIRE(list->get(3) == *(list->begin() + 3));
+    REQUIRE(0 == list->get(3).use_count());
+}
+
+namespace {
+    struct route {
+        string prefix;
+        int weight = 1;
+        vector<string> tags;
+    };
+
+    struct table {
+        string name;
+        int64_t version = 0;
+        double ratio = 0;
+        bool enabled = false;
+        vector<int> ports;
+        vector<route> routes;
+        route fallback;
+    };
+
+    config_schema<table> table_schema() {
+        config_schema<route> route_schema;
+        route_schema.field("prefix", &route::prefix).field("weight", &route::weight).field("tags", &route::tags);
+        config_schema<table> schema;
+        schema.field("name", &table::name).field("version", &table::version).field("ratio", &table::ratio)
+              .field("enabled", &table::enabled).field("ports", &table::ports)
+              .field("routes", &table::routes, route_schema).field("fallback", &table::fallback, route_schema);
+        return schema;
+    }
+}
+
+TEST_CASE("schemas load configs straight into structs") {
+    auto schema = table_schema();
+    string json = R"({ "name" : "main", "version" : 5000000000, "ratio" : 0.5, "enabled" : true,
+        "ports" : [80, 443], "unknown" : { "x" : [1, {"y" : null}] },
+        "routes" : [ { "prefix" : "/a", "tags" : ["x", "y"] }, { "prefix" : "/b", "weight" : 3 } ],
+        "fallback" : { "prefix" : "/" } })";
+    auto json_options = config_parse_options().set_syntax(config_syntax::JSON);
+
+    auto check = [](table const& t) {
+        REQUIRE("main" == t.name);
+        REQUIRE(5000000000 == t.version);
+        REQUIRE(0.5 == t.ratio);
+        REQUIRE(t.enabled);
+        REQUIRE((vector<int>{80, 443}) == t.ports);
+        REQUIRE(2u == t.routes.size());
+        REQUIRE("/a" == t.routes[0].prefix);
+        REQUIRE(1 == t.routes[0].weight);
+        REQUIRE((vector<string>{"x", "y"}) == t.routes[0].tags);
+        REQUIRE(3 == t.routes[1].weight);
+        REQUIRE("/" == t.fallback.prefix);
+    };
+
+    SECTION("plain JSON and HOCON are stored without building a config") {
+        table direct;
+        REQUIRE(schema.node()->parse_direct(json, json_options, &direct));
+        check(direct);
+        check(schema.parse_string(json, json_options));
+
+        string hocon = "name : main, version : 5000000000\nratio = 0.5\nenabled : true\nports : [80, 443]\n"
+                       "routes : [ { prefix : /a, tags : [x, y] }\n { prefix : \"/b\", weight : 3 } ]\n"
+                       "fallback.prefix : \"/\" // comment\n";
+        table from_hocon;
+        REQUIRE(schema.node()->parse_direct(hocon, config_parse_options(), &from_hocon));
+        check(from_hocon);
+    }
+
+    SECTION("anything else goes through the full parser") {
+        table t;
+        string with_substitution = "base : \"/\", name : main, version : 5000000000, ratio : 0.5, enabled : on,"
+                                   "ports : [80] [443], routes : [ { prefix : /a, tags : [x, y] }, "
+                                   "{ prefix : /b, weight : \"3\" } ], fallback { prefix : ${base} }";
+        REQUIRE_FALSE(schema.node()->parse_direct(with_substitution, config_parse_options(), &t));
+        check(schema.parse_string(with_substitution));
+
+        REQUIRE_FALSE(schema.node()->parse_direct("{ \"name\" : \"x\", }", json_options, &t));
+        REQUIRE_FALSE(schema.node()->parse_direct("name : a b", config_parse_options(), &t));
+        REQUIRE("a b" == schema.parse_string("name : a b").name);
+        REQUIRE(1 == schema.parse_string("ports : [1], ports : null").ports.empty());
+    }
+
+    SECTION("values of the wrong type are reported") {
+        REQUIRE_THROWS_AS(schema.parse_string("version : abc"), wrong_type_exception);
+        REQUIRE_THROWS_AS(schema.parse_string("routes : { prefix : x }"), wrong_type_exception);
+        REQUIRE_THROWS_AS(schema.parse_string("routes : [ { weight : 5000000000 } ]"), config_exception);
+    }
+
+    SECTION("files are read the same way") {
+        struct fixture { int from_json = 0; string from_json_a; };
+        config_schema<fixture> fixture_schema;
+        fixture_schema.field("fromJson1", &fixture::from_json).field("fromJsonA", &fixture::from_json_a);
+        auto f = fixture_schema.parse_file(TEST_FILE_DIR + string("/fixtures/test01.json"));
+        REQUIRE(1 == f.from_json);
+        REQUIRE("A" == f.from_json_a);
+    }
+}
+
+TEST_CASE("batch resolution reuses the base's resolved values") {
+    auto base = config::parse_string("host : a, port : 80, url : \"http://\"${host}\":\"${port}, name : base, "
+                                     "nested { deep : ${name}, fixed : 1 }, alias : ${url}, needs : ${tenant}");
+    config_batch_resolver batch(base);
+    REQUIRE(4 == batch.substituted_values());
+
+    vector<shared_config> overlays {
+        config::parse_string("host : b, tenant : t1"),
+        config::parse_string("name : other, tenant : t2"),
+        config::parse_string("tenant : t3, nested { fixed : 2 }"),
+    };
+    auto results = batch.resolve_all(overlays, 3);
+    REQUIRE(overlays.size() == results.size());
+    for (size_t i = 0; i < overlays.size(); ++i) {
+        auto expected = dynamic_pointer_cast<const config>(overlays[i]->with_fallback(base))->resolve();
+        REQUIRE(*expected->root() == *results[i].config->root());
+        REQUIRE(*results[i].config->root() == *batch.resolve(overlays[i]).config->root());
+        REQUIRE(results[i].shared_memory > 0);
+        REQUIRE(results[i].shared_memory < results[i].memory_usage);
+    }
+    REQUIRE("http://b:80" == results[0].config->get_string("alias"));
+    REQUIRE("other" == results[1].config->get_string("nested.deep"));
+
+    // values the overlay doesn't touch are the base's own
+    auto const& resolved = batch.resolved_base();
+    REQUIRE(resolved->get_value("nested") == results[0].config->get_value("nested"));
+    REQUIRE(resolved->get_value("url") == results[1].config->get_value("url"));
+    REQUIRE(resolved->get_value("alias") == results[2].config->get_value("alias"));
+    REQUIRE(resolved->get_value("url") != results[0].config->get_value("url"));
+
+    REQUIRE_THROWS_AS(batch.resolve(config::parse_string("x : 1")), unresolved_substitution_exception);
+}
+
+TEST_CASE("budgets limit the work of parsing and resolving") {
+    auto parse = [](string const& s, config_limits limits) {
+        return config::parse_string(s, config_parse_options().set_budget(make_shared<config_budget>(limits)));
+    };
+    auto resolve = [](shared_config const& c, config_limits limits) {
+        return c->resolve(config_resolve_options().set_budget(make_shared<config_budget>(limits)));
+    };
+
+    SECTION("without limits work is only counted") {
+        auto budget = make_shared<config_budget>(config_limits());
+        auto c = config::parse_string("a : 1, b : ${a}, c : [1, 2] [3], d { x : y }",
+                                      config_parse_options().set_budget(budget));
+        c->resolve(config_resolve_options().set_budget(budget));
+        REQUIRE(budget->bytes() == 0);
+        REQUIRE(budget->tokens() > 10);
+        REQUIRE(1 == budget->expansions());
+    }
+
+    SECTION("input size, tokens and nesting are limited while parsing") {
+        config_limits limits;
+        limits.max_bytes = 16;
+        REQUIRE_THROWS_AS(parse("a : 1, b : 2, c : 3, d : 4", limits), budget_exceeded_exception);
+        REQUIRE(1 == parse("a : 1, b : 2", limits)->get_int("a"));
+
+        limits = config_limits();
+        limits.max_tokens = 20;
+        REQUIRE_THROWS_AS(parse("a : 1, b : 2, c : 3, d : 4", limits), budget_exceeded_exception);
+        REQUIRE(2 == parse("a : 1, b : 2", limits)->get_int("b"));
+
+        limits = config_limits();
+        limits.max_depth = 2;
+        REQUIRE_THROWS_AS(parse("a { b { c : [1] } }", limits), budget_exceeded_exception);
+        REQUIRE(1 == parse("a { b { c : 1 } }", limits)->get_int("a.b.c"));
+    }
+
+    SECTION("includes are counted across files") {
+        string include = "include file(\"" + string(TEST_FILE_DIR) + "/fixtures/test01.json\")\n";
+        config_limits limits;
+        limits.max_includes = 1;
+        REQUIRE(1 == parse(include, limits)->get_int("fromJson1"));
+        REQUIRE_THROWS_AS(parse(include + include, limits), budget_exceeded_exception);
+    }
+
+    SECTION("expansions and concatenated output are limited while resolving") {
+        auto doubling = config::parse_string("a : xxxxxxxx, b : ${a}${a}, c : ${b}${b}, d : ${c}${c}, "
+                                             "e : ${d}${d}, f : ${e}${e}, g : ${f}${f}");
+        config_limits limits;
+        limits.max_output = 256;
+        REQUIRE_THROWS_AS(resolve(doubling, limits), budget_exceeded_exception);
+        limits.max_output = 1 << 16;
+        REQUIRE(512 == resolve(doubling, limits)->get_string("g").size());
+
+        limits = config_limits();
+        limits.max_expansions = 3;
+        REQUIRE_THROWS_AS(resolve(doubling, limits), budget_exceeded_exception);
+    }
+
+    SECTION("the time limit covers everything the budget is given to") {
+        config_limits limits;
+        limits.time_limit = chrono::milliseconds(1);
+        auto budget = make_shared<config_budget>(limits);
+        this_thread::sleep_for(chrono::milliseconds(5));
+        string big;
+        for (int i = 0; i < 200; ++i) {
+            big += "k" + to_string(i) + " : " + to_string(i) + "\n";
+        }
+        REQUIRE_THROWS_AS(config::parse_string(big, config_parse_options().set_budget(budget)),
+                          budget_exceeded_exception);
+    }
+}
@@ -1,7 +1,13 @@
 #include <catch.hpp>
 
+#include <hocon/config.hpp>
+#include <hocon/config_exception.hpp>
+#include <hocon/config_msgpack.hpp>
+#include <hocon/config_value_visitor.hpp>
 #include <internal/values/simple_config_object.hpp>
 #include <internal/values/simple_config_list.hpp>
+#include <internal/values/config_string.hpp>
+#include <internal/default_transformer.hpp>
 
 #include "test_utils.hpp"
 
@@ -109,3 +115,302 @@ TEST_CASE("config list unwraps") {
     bool test = expected == list->unwrapped();
     REQUIRE(test);
 };
+
+TEST_CASE("large lists of similar objects are packed without changing their values") {
+    // the same rows are parsed again as concatenated lists too short to pack, on the same lines
+    string text = "rows : [\n", unpacked_text = text;
+    for (int i = 0; i < 40; ++i) {
+        string row = "{ id : " + to_string(i) + ", weight : " + (i % 2 ? "0.50" : to_string(i)) +
+                ", name : \"row" + to_string(i) + "\", tag : bare, on : " + (i % 3 ? "true" : "false") + " }\n";
+        text += "  " + row;
+        unpacked_text += (i % 10 || !i ? "  " : "] [") + row;
+    }
+    text += "]\n";
+    unpacked_text += "]\n";
+    auto conf = config::parse_string(text);
+
+    auto list = dynamic_pointer_cast<const simple_config_list>(conf->get_list("rows"));
+    REQUIRE(list);
+    REQUIRE(list->packed());
+    REQUIRE(40u == list->size());
+
+    auto boxed = dynamic_pointer_cast<const simple_config_list>(config::parse_string(unpacked_text)->resolve()->get_list("rows"));
+    REQUIRE(boxed);
+    REQUIRE_FALSE(boxed->packed());
+    REQUIRE(40u == boxed->size());
+
+    // the boxed list's own usage doesn't count its rows, so add what they take at the very least
+    size_t boxed_usage = boxed->memory_usage();
+    for (auto const& row : *boxed) {
+        boxed_usage += sizeof(simple_config_object) +
+            dynamic_pointer_cast<const config_object>(row)->size() * (sizeof(config_string) + sizeof(shared_value));
+    }
+    REQUIRE(list->memory_usage() * 2 < boxed_usage);
+
+    for (size_t i = 0; i < list->size(); ++i) {
+        auto row = dynamic_pointer_cast<const config_object>(list->get(i));
+        REQUIRE(row);
+        REQUIRE(static_cast<int>(i) + 2 == row->origin()->line_number());
+        REQUIRE(row->get("id")->origin()->line_number() == row->origin()->line_number());
+        REQUIRE(*row == *boxed->get(i));
+    }
+    REQUIRE(*list == *boxed);
+
+    // reading every element, however it's done, doesn't leave the list unpacked
+    auto packed_usage = list->memory_usage();
+    REQUIRE(40u == conf->get_object_list("rows").size());
+    REQUIRE(40u == static_cast<size_t>(distance(list->begin(), list->end())));
+    REQUIRE(list->contains(list->get(5)));
+    REQUIRE(5 == list->index_of(boxed->get(5)));
+    REQUIRE(packed_usage == list->memory_usage());
+    shared_list as_list = list, as_boxed = boxed;
+    REQUIRE(as_boxed->render() == as_list->render());
+    REQUIRE(as_boxed->render(config_render_options::concise()) == as_list->render(config_render_options::concise()));
+
+    auto rows = conf->get_object_list("rows");
+    REQUIRE("0.50" == rows[1]->get("weight")->render());
+    REQUIRE("2" == rows[2]->get("weight")->render());
+    REQUIRE("row7" == rows[7]->to_config()->get_string("name"));
+    REQUIRE_FALSE(rows[3]->to_config()->get_bool("on"));
+}
+
+TEST_CASE("large lists of numbers and booleans are packed") {
+    string ints = "ints : [", doubles = "doubles : [", bools = "bools : [";
+    for (int i = 0; i < 100; ++i) {
+        ints += to_string(i * 1000) + ",";
+        doubles += (i % 4 ? to_string(i) + ".25" : to_string(i)) + ",";
+        bools += string(i % 3 ? "true" : "false") + ",";
+    }
+    auto conf = config::parse_string(ints + "]\n" + doubles + "]\n" + bools + "\nfalse]\nbig : [" + ints.substr(8) +
+                                     "5000000000]\nmixed : [" + ints.substr(8) + "x]\n");
+
+    auto list = conf->get_list("ints");
+    REQUIRE(100u == list->packed_longs().size);
+    REQUIRE(99000 == list->packed_longs().data[99]);
+    REQUIRE(list->packed_doubles().empty());
+    REQUIRE(99000 == conf->get_int_list("ints")[99]);
+    REQUIRE(99000 == conf->get_long_list("ints")[99]);
+    REQUIRE(99000.0 == conf->get_double_list("ints")[99]);
+    REQUIRE(1 == list->origin()->line_number());
+    REQUIRE(1 == list->get(5)->origin()->line_number());
+    REQUIRE(config_value::type::NUMBER == list->get(5)->value_type());
+
+    auto doubles_list = conf->get_list("doubles");
+    REQUIRE(100u == doubles_list->packed_doubles().size);
+    REQUIRE(1.25 == conf->get_double_list("doubles")[1]);
+    // doubles with a fraction aren't truncated into longs, packed or not
+    REQUIRE_THROWS_AS(conf->get_long_list("doubles"), wrong_type_exception);
+    REQUIRE_THROWS_AS(conf->get_int_list("doubles"), wrong_type_exception);
+    auto small = config::parse_string("fraction : [1, 2.5], whole : [1, 2.0]");
+    REQUIRE_THROWS_AS(small->get_long_list("fraction"), wrong_type_exception);
+    REQUIRE_THROWS_AS(small->get_int_list("fraction"), wrong_type_exception);
+    REQUIRE((vector<int64_t> { 1, 2 }) == small->get_long_list("whole"));
+    REQUIRE((vector<int> { 1, 2 }) == small->get_int_list("whole"));
+    REQUIRE("4" == doubles_list->get(4)->render());
+    REQUIRE("5.25" == doubles_list->get(5)->render());
+
+    auto bool_list = conf->get_list("bools");
+    REQUIRE(101u == bool_list->size());
+    auto bools_read = conf->get_bool_list("bools");
+    REQUIRE_FALSE(bools_read[0]);
+    REQUIRE(bools_read[1]);
+    REQUIRE(4 == bool_list->get(100)->origin()->line_number());
+    REQUIRE_THROWS_AS(bool_list->get(101), std::out_of_range);
+
+    REQUIRE(conf->get_list("big")->packed_longs().size == 101u);
+    REQUIRE_THROWS(conf->get_int_list("big"));
+    REQUIRE(5000000000 == conf->get_long_list("big")[100]);
+
+    REQUIRE(conf->get_list("mixed")->packed_longs().empty());
+    REQUIRE_THROWS_AS(conf->get_long_list("mixed"), wrong_type_exception);
+
+    for (auto path : { "ints", "doubles", "bools", "big" }) {
+        auto packed = dynamic_pointer_cast<const simple_config_list>(conf->get_list(path));
+        auto boxed = make_shared<simple_config_list>(packed->origin(), vector<shared_value>(packed->begin(), packed->end()));
+        shared_list as_packed = packed, as_boxed = boxed;
+        REQUIRE(*packed == *boxed);
+        REQUIRE(as_boxed->render() == as_packed->render());
+    }
+}
+
+TEST_CASE("coercions of strings are kept on the string") {
+    auto number = make_shared<config_string>(fake_origin(), "42", config_string_type::UNQUOTED);
+    auto coerced = default_transformer::transform(number, config_value::type::NUMBER);
+    REQUIRE(config_value::type::NUMBER == coerced->value_type());
+    REQUIRE(coerced == default_transformer::transform(number, config_value::type::NUMBER));
+    // failed coercions give back the string
+    REQUIRE(number == default_transformer::transform(number, config_value::type::BOOLEAN));
+
+    auto yes = make_shared<config_string>(fake_origin(), "yes", config_string_type::UNQUOTED);
+    auto boolean = default_transformer::transform(yes, config_value::type::BOOLEAN);
+    REQUIRE(true == boolean->unwrapped().get<bool>());
+    REQUIRE(boolean == default_transformer::transform(yes, config_value::type::BOOLEAN));
+
+    int parses = 0;
+    auto parse = [&]() { ++parses; return duration(10, 0); };
+    REQUIRE(duration(10, 0) == yes->memoized_duration(parse));
+    REQUIRE(duration(10, 0) == yes->memoized_duration(parse));
+    REQUIRE(1 == parses);
+
+    auto conf = config::parse_string("port : \"8080\", enabled : on, bad : 10 parsecs")->resolve();
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(8080 == conf->get_int("port"));
+        REQUIRE(conf->get_bool("enabled"));
+        REQUIRE_THROWS_AS(conf->get_duration("bad", time_unit::SECONDS), bad_value_exception);
+    }
+}
+
+namespace {
+    // rebuilds the unwrapped form of a value, to check against unwrapped()
+    struct unwrapping_visitor : config_value_visitor {
+        vector<unwrapped_value> stack;
+        vector<string> keys;
+        vector<size_t> sizes;
+
+        void add(unwrapped_value v) {
+            if (stack.empty()) {
+                stack.push_back(move(v));
+            } else if (stack.back().is_object()) {
+                stack.back()[keys.back()] = move(v);
+                keys.pop_back();
+            } else {
+                stack.back().push_back(move(v));
+            }
+        }
+        void finish() {
+            REQUIRE(sizes.back() == stack.back().size());
+            sizes.pop_back();
+            if (stack.size() > 1) {
+                auto done = move(stack.back());
+                stack.pop_back();
+                add(move(done));
+            }
+        }
+
+        void begin_object(size_t size) override { stack.push_back(unwrapped_value::object()); sizes.push_back(size); }
+        void key(string const& key) override { keys.push_back(key); }
+        void end_object() override { finish(); }
+        void begin_list(size_t size) override { stack.push_back(unwrapped_value::array()); sizes.push_back(size); }
+        void end_list() override { finish(); }
+        void null_value() override { add(nullptr); }
+        void boolean_value(bool value) override { add(value); }
+        void long_value(int64_t value) override { add(value); }
+        void double_value(double value) override { add(value); }
+        void string_value(string const& value) override { add(value); }
+    };
+}
+
+TEST_CASE("visitors see the same values as unwrapped") {
+    string ints = "[", doubles = "[", objects = "[";
+    for (int i = 0; i < 20; ++i) {
+        ints += to_string(i * 7) + ",";
+        doubles += to_string(i) + (i % 2 ? ".5," : ",");
+        objects += "{ id : " + to_string(i) + ", on : " + (i % 2 ? "true" : "false") + " },";
+    }
+    auto conf = config::parse_string("a : { b : 1, c : [1.5, \"x\", null, true] }, s : hello, empty : {}, "
+                                     "ints : " + ints + "], doubles : " + doubles + "], "
+                                     "objects : " + objects + "], ref : ${a.b}")->resolve();
+    REQUIRE_FALSE(conf->get_list("ints")->packed_longs().empty());
+    REQUIRE_FALSE(conf->get_list("doubles")->packed_doubles().empty());
+
+    unwrapping_visitor visitor;
+    conf->root()->accept(visitor);
+    REQUIRE(1u == visitor.stack.size());
+    REQUIRE(conf->root()->unwrapped() == visitor.stack.back());
+
+    unwrapping_visitor scalar;
+    conf->get_value("s")->accept(scalar);
+    REQUIRE("hello" == scalar.stack.back());
+
+    auto unresolved = config::parse_string("x : ${y}, y : 1");
+    unwrapping_visitor never;
+    REQUIRE_THROWS_AS(unresolved->root()->accept(never), not_resolved_exception);
+}
+
+TEST_CASE("values round trip through MessagePack") {
+    string ints = "[", objects = "[";
+    for (int i = 0; i < 20; ++i) {
+        ints += to_string(i * 100000 - 70) + ",";
+        objects += "{ id : " + to_string(i) + ", w : 0." + to_string(i + 1) + " },";
+    }
+    auto conf = config::parse_string("a : { b : -5000000000, c : [1.5, \"x\", null, true, false] }\n"
+                                     "s : \"" + string(300, 'y') + "\"\n"
+                                     "empty : {}, ints : " + ints + "]\nobjects : " + objects + "]")->resolve();
+    auto root = conf->root();
+
+    auto bytes = config_msgpack::encode(root);
+    auto decoded = config_msgpack::decode(bytes, "from msgpack");
+    REQUIRE(root->unwrapped() == decoded->unwrapped());
+    REQUIRE("from msgpack" == decoded->origin()->description());
+    auto decoded_conf = dynamic_pointer_cast<const config_object>(decoded)->to_config();
+    REQUIRE(-5000000000 == decoded_conf->get_long("a.b"));
+    REQUIRE(20u == decoded_conf->get_list("ints")->packed_longs().size);
+    REQUIRE(bytes.size() < root->render(config_render_options::concise()).size());
+
+    auto with_lines = config_msgpack::decode(config_msgpack::encode(root, true));
+    auto lines_conf = dynamic_pointer_cast<const config_object>(with_lines)->to_config();
+    REQUIRE(root->unwrapped() == with_lines->unwrapped());
+    REQUIRE(2 == lines_conf->get_value("s")->origin()->line_number());
+    REQUIRE(4 == lines_conf->get_list("objects")->get(3)->origin()->line_number());
+    REQUIRE(1 == lines_conf->get_list("a.c")->get(1)->origin()->line_number());
+
+    // numbers render as what they read back as, whole values in a double column as longs
+    string mixed = "[";
+    for (int i = 1; i < 20; ++i) {
+        mixed += to_string(i) + ",";
+    }
+    auto numbers = config::parse_string("tiny : 0.000000001, big : 1e300, mixed : " + mixed + "19.5]")->resolve()->root();
+    auto numbers_decoded = config_msgpack::decode(config_msgpack::encode(numbers));
+    auto rendered = numbers_decoded->render(config_render_options::concise());
+    REQUIRE(rendered.find("\"tiny\":1e-09") != string::npos);
+    REQUIRE(rendered.find("1,2,3,") != string::npos);
+    REQUIRE(rendered.find("19.5]") != string::npos);
+    REQUIRE(numbers->unwrapped() == config::parse_string(rendered)->root()->unwrapped());
+    REQUIRE(rendered ==
+            config_msgpack::decode(config_msgpack::encode(numbers_decoded))->render(config_render_options::concise()));
+
+    REQUIRE_THROWS_AS(config_msgpack::decode(bytes.substr(0, bytes.size() - 1)), parse_exception);
+    REQUIRE_THROWS_AS(config_msgpack::decode(bytes + "x"), parse_exception);
+    REQUIRE_THROWS_AS(config_msgpack::decode("\x81\x01\x02"), parse_exception);
+    REQUIRE_THROWS_AS(config_msgpack::decode(string(2000, '\x91')), parse_exception);
+    REQUIRE_THROWS_AS(config_msgpack::encode(config::parse_string("x : ${y}, y : 1")->root()), not_resolved_exception);
+}
+
+TEST_CASE("objects merged over large resolved objects are overlays") {
+    string text = "defaults { a : 1, b : 2, c : 3, d : 4, e : 5, f : 6, g : 7, nested { x : 1, y : 2 } }\n";
+    for (int i = 0; i < 20; ++i) {
+        text += "shard_" + to_string(i) + " = ${defaults} { id = " + to_string(i) + ", nested { x = " +
+                to_string(i) + " } }\n";
+    }
+    auto conf = config::parse_string(text)->resolve();
+    auto shard = [&](int i) {
+        return dynamic_pointer_cast<const simple_config_object>(conf->get_value("shard_" + to_string(i)));
+    };
+
+    // every shard shares the resolved defaults
+    REQUIRE(shard(3)->overlay_base());
+    REQUIRE(shard(3)->overlay_base() == shard(17)->overlay_base());
+    REQUIRE(9 == shard(3)->size());
+    REQUIRE(3 == conf->get_int("shard_3.id"));
+    REQUIRE(4 == conf->get_int("shard_3.d"));
+    REQUIRE(3 == conf->get_int("shard_3.nested.x"));
+    REQUIRE(2 == conf->get_int("shard_3.nested.y"));
+    REQUIRE(shard(3)->is_deferred());
+
+    // iterating sees the merged entries
+    auto unwrapped = shard(5)->unwrapped();
+    REQUIRE_FALSE(shard(5)->is_deferred());
+    auto expected = config::parse_string("a : 1, b : 2, c : 3, d : 4, e : 5, f : 6, g : 7, id : 5, nested { x : 5, y : 2 }");
+    REQUIRE(expected->root()->unwrapped() == unwrapped);
+    REQUIRE(9 == shard(5)->size());
+
+    // small objects, and overlays of overlays, are merged as before
+    auto small = config::parse_string("base { a : 1, b : 2 }, top = ${base} { b : 3 }")->resolve();
+    REQUIRE_FALSE(dynamic_pointer_cast<const simple_config_object>(small->get_value("top"))->overlay_base());
+    auto chained = config::parse_string(text + "again = ${shard_2} { id = 100, z = 0 }")->resolve();
+    auto again = dynamic_pointer_cast<const simple_config_object>(chained->get_value("again"));
+    REQUIRE(again->overlay_base() == dynamic_pointer_cast<const simple_config_object>(chained->get_value("defaults")));
+    REQUIRE(100 == chained->get_int("again.id"));
+    REQUIRE(2 == chained->get_int("again.nested.x"));
+    REQUIRE(10 == again->size());
+}
@@ -6,6 +6,10 @@
 
 #include <boost/algorithm/string/replace.hpp>
 
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
 using namespace std;
 
 namespace hocon { namespace test_utils {
@@ -449,4 +453,20 @@ namespace hocon { namespace test_utils {
     std::string fixture_path(std::string const& fixture_name) {
         return string(TEST_FILE_DIR) + "/fixtures/" + fixture_name;
     }
+
+    static string temp_directory() {
+        for (auto variable : { "TMPDIR", "TEMP", "TMP" }) {
+            if (auto dir = getenv(variable)) {
+                return dir;
+            }
+        }
+        return "/tmp";
+    }
+
+    temp_file::temp_file(string const& name) :
+        path(temp_directory() + "/" + to_string(random_device()()) + "_" + name) {}
+
+    temp_file::~temp_file() {
+        remove(path.c_str());
+    }
 }}  // namespace hocon::test_utils
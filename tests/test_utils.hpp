@@ -137,4 +137,17 @@ namespace hocon { namespace test_utils {
     std::vector<parse_test> whitespace_variations(std::vector<parse_test> const& tests, bool valid_in_lift);
 
     std::string fixture_path(std::string const& fixture_name);
+
+    /**
+     * A path in the system's temporary directory for a file named after name;
+     * the file is removed, if it was made, when this goes out of scope.
+     */
+    struct temp_file {
+        explicit temp_file(std::string const& name);
+        ~temp_file();
+        temp_file(temp_file const&) = delete;
+        temp_file& operator=(temp_file const&) = delete;
+
+        std::string const path;
+    };
 }}  // namespace hocon::test_utils
@@ -692,3 +692,43 @@ TEST_CASE("catch syntax erros", "[tokenizer]") {
         REQUIRE_THROWS(test_for_config_error(source));
     }
 }
+
+TEST_CASE("parallel tokenizing gives the same tokens", "[tokenizer]") {
+    string block =
+        "a : 1, b = \"two # not a comment\" // but this is \"\n"
+        "c : \"\"\"triple\n"
+        "quoted \"\" with # and // and ${x}\n"
+        "\"\"\"\"\n"
+        "d : ${?a} ${b}  foo  bar ${c.\"}\"}\n"
+        "e : [ true, false, null, 3.5e2, -7 ] # comment with \" and \"\"\"\n"
+        "f { g : \"esc\\\"aped\\\\\", h : \"\\u0041\" }\n"
+        "i : ${a${b}\n"
+        "  }\n"
+        "\n"
+        "   j : unquoted text  \n";
+    string source;
+    for (int i = 0; i < 40; ++i) {
+        source += block;
+    }
+
+    token_list expected = tokenize_as_list(source);
+    for (unsigned threads : { 1u, 2u, 3u, 8u, 64u }) {
+        auto iter = token_iterator::tokenize_parallel(fake_origin(), source, config_syntax::CONF, threads);
+        token_list result;
+        while (iter.has_next()) {
+            result.push_back(iter.next());
+        }
+        REQUIRE(expected.size() == result.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            REQUIRE(*expected[i] == *result[i]);
+            REQUIRE(expected[i]->token_text() == result[i]->token_text());
+            REQUIRE(expected[i]->line_number() == result[i]->line_number());
+        }
+    }
+
+    SECTION("errors are the same as tokenizing sequentially") {
+        auto iter = token_iterator::tokenize_parallel(fake_origin(), source + "k : \"open\nl : 1\n" + source,
+                                                      config_syntax::CONF, 4);
+        REQUIRE_THROWS_AS([&]() { while (iter.has_next()) { iter.next(); } }(), config_exception);
+    }
+}